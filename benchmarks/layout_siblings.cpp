@@ -0,0 +1,102 @@
+// Layout of 100k siblings under one parent: per object path (getRealObject2Dsize / getRealObject2Dposition)
+// against LayoutStore sweep, scalar and vectorized. No window is opened.
+//
+// Build like any simpleUI program, with the SIMD level you want to measure, e.g.:
+// g++ -std=c++20 -O2 -mavx -Iinclude benchmarks/layout_siblings.cpp -Llib -lraylib -lSUIutils -o layout_siblings
+
+#include <simpleUI.h>
+#include <chrono>
+
+constexpr int SIBLINGS = 100000;
+constexpr int RUNS = 50;
+
+template <typename F>
+double bestOf(F f) { // nanoseconds per sibling, best run
+	double best = 1e30;
+	for (int r = 0; r < RUNS; r++) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count());
+	}
+	return best / SIBLINGS;
+}
+
+int main() {
+	winWidth = 1920;
+	winHeight = 1080;
+
+	Instance* root = new Instance(true);
+	Object2D* list = new Object2D(root);
+	list->Size = SpecialVector2{ 0.8, 0.9 };
+	list->PositionOFFSET = SpecialVector2{ 20, 30 };
+
+	std::vector<Object2D*> items;
+	for (int i = 0; i < SIBLINGS; i++) {
+		Object2D* item = new Object2D(list);
+		item->Size = SpecialVector2{ 1, 0 };
+		item->SizeOFFSET = SpecialVector2{ -10.0f - i % 7, 24.0f + i % 5 };
+		item->Position = SpecialVector2{ 0.5, 0 };
+		item->PositionOFFSET = SpecialVector2{ 0, 26.0f * i };
+		item->AnchorPosition = SpecialVector2{ 0.5, 0 };
+		items.push_back(item);
+	}
+
+	list->getRealObject2Dsize();
+	list->getRealObject2Dposition();
+
+	double perObject = bestOf([&]() {
+		for (Object2D* item : items) {
+			item->RelativeSCalculated = false;
+			item->RelativePCalculated = false;
+			item->getRealObject2Dsize();
+			item->getRealObject2Dposition();
+		}
+	});
+
+	std::vector<SpecialVector2> expectedSize, expectedPos;
+	for (Object2D* item : items) {
+		expectedSize.push_back(item->RealSize);
+		expectedPos.push_back(item->RealPos);
+	}
+
+	LayoutStore::Enabled = true;
+	LayoutStore::Solve(root);
+
+	LayoutStore::Vectorized = false;
+	double scalar = bestOf([]() { LayoutStore::sweep(); });
+
+	LayoutStore::Vectorized = true;
+	double vectorized = bestOf([]() { LayoutStore::sweep(); });
+
+	double solve = bestOf([]() {
+		LayoutStore::valuesDirty = true;
+		LayoutStore::Solve(LayoutStore::root);
+	});
+
+	int mismatches = 0;
+	for (int i = 0; i < SIBLINGS; i++) {
+		Object2D* item = items[i];
+		if (std::memcmp(&expectedSize[i].x.n, &item->RealSize.x.n, sizeof(float)) or std::memcmp(&expectedSize[i].y.n, &item->RealSize.y.n, sizeof(float))
+			or std::memcmp(&expectedPos[i].x.n, &item->RealPos.x.n, sizeof(float)) or std::memcmp(&expectedPos[i].y.n, &item->RealPos.y.n, sizeof(float))) {
+			mismatches++;
+		}
+	}
+
+#if defined(__AVX__)
+	const char* isa = "AVX";
+#elif defined(__SSE2__) or defined(_M_X64)
+	const char* isa = "SSE2";
+#else
+	const char* isa = "scalar";
+#endif
+
+	std::cout << SIBLINGS << " siblings, best of " << RUNS << " runs, ns per object" << std::endl;
+	std::cout << "per object path:      " << perObject << std::endl;
+	std::cout << "store sweep, scalar:  " << scalar << std::endl;
+	std::cout << "store sweep, " << isa << ":    " << vectorized << std::endl;
+	std::cout << "store solve (sweep + copy back): " << solve << std::endl;
+	std::cout << "results differing from per object path: " << mismatches << std::endl;
+
+	return mismatches != 0;
+}
@@ -0,0 +1,95 @@
+// Layout pass of ~200k objects spread over 64 top level panels with a ScrollFrame each:
+// LayoutStore sweep on the main thread against the work stealing pool. No window is opened.
+// Results of every thread count are compared bit for bit with the serial sweep.
+//
+// Build like any simpleUI program, e.g.:
+// g++ -std=c++20 -O2 -Iinclude benchmarks/layout_threads.cpp -Llib -lraylib -lSUIutils -o layout_threads
+
+#include <simpleUI.h>
+#include <chrono>
+
+constexpr int PANELS = 64;
+constexpr int ROWS = 1000; // per panel, every row has two children
+constexpr int RUNS = 30;
+
+template <typename F>
+double bestOf(F f) { // milliseconds, best run
+	double best = 1e30;
+	for (int r = 0; r < RUNS; r++) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	return best;
+}
+
+bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+	return a.size() == b.size() and std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+int main() {
+	winWidth = 1920;
+	winHeight = 1080;
+
+	Instance* root = new Instance(true);
+	for (int p = 0; p < PANELS; p++) {
+		Object2D* panel = new Object2D(root);
+		panel->Size = SpecialVector2{ 1.0f / 8, 1.0f / 8 };
+		panel->Position = SpecialVector2{ (p % 8) / 8.0f, (p / 8) / 8.0f };
+
+		ScrollFrame* scroll = new ScrollFrame(panel);
+		scroll->Size = SpecialVector2{ 1, 1 };
+		scroll->SizeOFFSET = SpecialVector2{ -8, -8 };
+		scroll->CanvasSize = SpecialVector2{ 1, 40 };
+		scroll->CanvasPositionOFFSET = SpecialVector2{ 0, 3.0f * p };
+
+		for (int r = 0; r < ROWS; r++) {
+			Object2D* row = new Object2D(scroll);
+			row->Size = SpecialVector2{ 1, 0 };
+			row->SizeOFFSET = SpecialVector2{ -4, 20.0f + r % 3 };
+			row->PositionOFFSET = SpecialVector2{ 2, 22.0f * r };
+
+			Object2D* icon = new Object2D(row);
+			icon->Size = SpecialVector2{ 0, 1 };
+			icon->SizeOFFSET = SpecialVector2{ 16, -4 };
+			icon->Position = SpecialVector2{ 0, 0.5 };
+			icon->AnchorPosition = SpecialVector2{ 0, 0.5 };
+
+			Object2D* text = new Object2D(row);
+			text->Size = SpecialVector2{ 1, 1 };
+			text->SizeOFFSET = SpecialVector2{ -24, 0 };
+			text->PositionOFFSET = SpecialVector2{ 22, 0 };
+		}
+	}
+
+	LayoutStore::Enabled = true;
+	LayoutStore::Solve(root);
+	size_t nodes = LayoutStore::Nodes.size();
+
+	double serial = bestOf([]() { LayoutStore::sweep(); });
+	std::vector<float> sizeX = LayoutStore::RealSizeX, sizeY = LayoutStore::RealSizeY;
+	std::vector<float> posX = LayoutStore::RealPosX, posY = LayoutStore::RealPosY;
+
+	std::cout << nodes << " objects in " << LayoutStore::Segments.size() << " segments, best of " << RUNS << " runs, ms per layout pass" << std::endl;
+	std::cout << "serial:    " << serial << std::endl;
+
+	int mismatches = 0;
+	int hardware = std::max(2, (int)std::thread::hardware_concurrency());
+	for (int threads = 2; threads <= hardware; threads *= 2) {
+		LayoutStore::StartThreads(threads);
+		for (std::vector<float>* v : { &LayoutStore::RealSizeX, &LayoutStore::RealSizeY, &LayoutStore::RealPosX, &LayoutStore::RealPosY }) {
+			std::fill(v->begin(), v->end(), 0.0f);
+		}
+
+		double parallel = bestOf([]() { LayoutStore::sweepParallel(); });
+		bool same = sameBits(sizeX, LayoutStore::RealSizeX) and sameBits(sizeY, LayoutStore::RealSizeY)
+			and sameBits(posX, LayoutStore::RealPosX) and sameBits(posY, LayoutStore::RealPosY);
+		if (!same) mismatches++;
+
+		std::cout << threads << " threads: " << parallel << " (x" << serial / parallel << ")" << (same ? "" : " RESULTS DIFFER") << std::endl;
+	}
+	LayoutStore::StopThreads();
+
+	return mismatches != 0;
+}
@@ -0,0 +1,254 @@
+// Scenario suite run without a window (HEADLESS_NULL, see SUI_SetHeadless): every scenario builds its tree,
+// runs warmup frames and then measured frames through SUI_Step with injected input. Percentiles of the
+// Profiler phases and heap allocations per frame are written as JSON, so two builds can be compared in CI.
+//
+// Usage: suite [--scale 0.1] [--frames 300] [--only scroll] [--no-store] [--out results.json]
+// --scale multiplies object counts (1 is the full size, the scroll scenario then has 1M rows),
+// --no-store keeps layout inside the draw phase instead of the LayoutStore pass.
+// Scenarios share one process and are not deleted afterwards, use --only for big scales.
+//
+// Build like any simpleUI program and run it from the repository root so Fonts/ is found, e.g.:
+// g++ -std=c++20 -O2 -Iinclude benchmarks/suite.cpp -Llib -lraylib -lSUIutils -o suite
+
+#include <simpleUI.h>
+#include <chrono>
+#include <new>
+
+static_assert(SUI_PROFILER, "the suite reads the phase times of Profiler, build without SUI_PROFILER=0");
+
+static std::atomic<unsigned long long> allocations{ 0 };
+static std::atomic<unsigned long long> allocatedBytes{ 0 };
+
+// kept out of line, GCC would otherwise pair the inlined free with the standard operator new (-Wmismatched-new-delete)
+#if defined(_MSC_VER)
+#define SUITE_NOINLINE __declspec(noinline)
+#else
+#define SUITE_NOINLINE __attribute__((noinline))
+#endif
+
+SUITE_NOINLINE void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+SUITE_NOINLINE void operator delete(void* p) noexcept { std::free(p); }
+SUITE_NOINLINE void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+constexpr int WIDTH = 1920;
+constexpr int HEIGHT = 1080;
+constexpr int WARMUP = 20;
+
+struct Scenario {
+	const char* Name;
+	std::function<int(Instance*, float)> Build; // returns the number of objects
+	std::function<void(int)> Frame; // called before every step
+};
+
+struct Series {
+	std::vector<double> Values;
+
+	void write(std::ostream& out, double scale) { // percentiles of the sorted values
+		if (Values.empty()) {
+			out << "{ \"mean\": null, \"p50\": null, \"p90\": null, \"p99\": null, \"max\": null }";
+			return;
+		}
+		std::sort(Values.begin(), Values.end());
+		auto at = [&](double p) { return Values[std::min(Values.size() - 1, (size_t)(p * Values.size()))] * scale; };
+		double sum = 0;
+		for (double v : Values) sum += v;
+
+		out << "{ \"mean\": " << sum / Values.size() * scale << ", \"p50\": " << at(0.5) << ", \"p90\": " << at(0.9)
+			<< ", \"p99\": " << at(0.99) << ", \"max\": " << Values.back() * scale << " }";
+	}
+};
+
+std::vector<Object2D*> grid(Instance* parent, int count, float cell, bool active) { // count objects filling the window row by row
+	std::vector<Object2D*> objects;
+	int columns = std::max(1, (int)(WIDTH / cell));
+	for (int i = 0; i < count; i++) {
+		Object2D* obj = new Object2D(parent);
+		obj->PositionOFFSET = SpecialVector2{ (i % columns) * cell, std::fmod((i / columns) * cell, (float)HEIGHT) };
+		obj->SizeOFFSET = SpecialVector2{ cell - 1, cell - 1 };
+		obj->BackgroundColor = { (unsigned char)(i * 7), (unsigned char)(i * 13), 200, 255 };
+		obj->ZIndex = i % 3;
+		obj->Active = active;
+		objects.push_back(obj);
+	}
+	return objects;
+}
+
+std::vector<Scenario> scenarios() {
+	static std::vector<Object2D*> objects;
+	static std::vector<TextLabel*> labels;
+
+	return {
+		{ "flat", [](Instance* root, float scale) { // siblings of one parent, one of them moves every frame
+			objects = grid(root, (int)(100000 * scale), 6, false);
+			return (int)objects.size();
+		}, [](int frame) {
+			Object2D* obj = objects[(frame * 7919) % objects.size()];
+			obj->PositionOFFSET = SpecialVector2{ obj->PositionOFFSET.x, obj->PositionOFFSET.y + (frame % 2 ? 1.0f : -1.0f) };
+		} },
+
+		{ "deep", [](Instance* root, float scale) { // chains 1000 levels deep, the top of one of them moves every frame
+			objects.clear();
+			int chains = std::max(1, (int)(50 * scale));
+			for (int c = 0; c < chains; c++) {
+				Object2D* top = new Object2D(root);
+				top->PositionOFFSET = SpecialVector2{ c * 30.0f, 0 };
+				top->SizeOFFSET = SpecialVector2{ 28, (float)HEIGHT };
+				objects.push_back(top);
+
+				Object2D* parent = top;
+				for (int d = 1; d < 1000; d++) {
+					Object2D* obj = new Object2D(parent);
+					obj->Size = SpecialVector2{ 1, 1 };
+					obj->SizeOFFSET = SpecialVector2{ 0, -1 };
+					obj->PositionOFFSET = SpecialVector2{ 0, 1 };
+					obj->BackgroundColor = { 40, (unsigned char)d, 90, 255 };
+					parent = obj;
+				}
+			}
+			return chains * 1000;
+		}, [](int frame) {
+			Object2D* top = objects[frame % objects.size()];
+			top->PositionOFFSET = SpecialVector2{ top->PositionOFFSET.x, (float)(frame % 5) };
+		} },
+
+		{ "scroll", [](Instance* root, float scale) { // TextLabel rows in a ScrollFrame scrolled by the wheel
+			int rows = (int)(1000000 * scale);
+			ScrollFrame* scroll = new ScrollFrame(root);
+			scroll->Size = SpecialVector2{ 1, 1 };
+			scroll->CanvasSizeOFFSET = SpecialVector2{ 0, rows * 24.0f };
+			scroll->Active = true;
+
+			for (int r = 0; r < rows; r++) {
+				TextLabel* row = new TextLabel(scroll);
+				row->Size = SpecialVector2{ 1, 0 };
+				row->SizeOFFSET = SpecialVector2{ 0, 22 };
+				row->PositionOFFSET = SpecialVector2{ 0, r * 24.0f };
+				row->Text = "Row " + std::to_string(r);
+				row->TextAnchor = TextAnchorEnum::W;
+			}
+			SUI_InjectMouseMove(WIDTH / 2, HEIGHT / 2);
+			return rows + 1;
+		}, [](int) {
+			SUI_InjectWheel(-1);
+		} },
+
+		{ "text", [](Instance* root, float scale) { // every label gets new text every frame
+			labels.clear();
+			int count = (int)(20000 * scale);
+			int columns = 20;
+			for (int i = 0; i < count; i++) {
+				TextLabel* label = new TextLabel(root);
+				label->SizeOFFSET = SpecialVector2{ (float)WIDTH / columns, 20 };
+				label->PositionOFFSET = SpecialVector2{ (i % columns) * (float)WIDTH / columns, std::fmod((i / columns) * 20.0f, (float)HEIGHT) };
+				labels.push_back(label);
+			}
+			return count;
+		}, [](int frame) {
+			for (size_t i = 0; i < labels.size(); i++) {
+				labels[i]->SetText(std::to_string(frame * 31 + i));
+			}
+		} },
+
+		{ "animate", [](Instance* root, float scale) { // one animation per object, started again every 30 frames
+			objects = grid(root, (int)(50000 * scale), 8, false);
+			return (int)objects.size();
+		}, [](int frame) {
+			if (frame % 30) return;
+			for (Object2D* obj : objects) {
+				Animate::Create(&obj->BackgroundTransparency, 0.4f, frame % 60 ? 0.0f : 0.8f, Animate::Quad);
+			}
+		} },
+
+		{ "hit", [](Instance* root, float scale) { // active objects under a mouse sweeping the window
+			objects = grid(root, (int)(10000 * scale), 12, true);
+			return (int)objects.size();
+		}, [](int frame) {
+			float x = (frame * 37) % WIDTH;
+			float y = ((frame * 37) / WIDTH * 53 + frame * 3) % HEIGHT;
+			SUI_InjectMouseMove(x, y);
+		} },
+	};
+}
+
+int main(int argc, char** argv) {
+	float scale = 1;
+	int frames = 300;
+	std::string only, outPath;
+	bool store = true;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--scale" and i + 1 < argc) scale = std::stof(argv[++i]);
+		else if (arg == "--frames" and i + 1 < argc) frames = std::stoi(argv[++i]);
+		else if (arg == "--only" and i + 1 < argc) only = argv[++i];
+		else if (arg == "--out" and i + 1 < argc) outPath = argv[++i];
+		else if (arg == "--no-store") store = false;
+		else {
+			std::cout << "unknown argument " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	SUI_SetHeadless(HEADLESS_NULL);
+	LayoutStore::Enabled = store;
+	SUI_Open({ WIDTH, HEIGHT, 0 }, "suite");
+
+	std::ofstream file;
+	if (!outPath.empty()) file.open(outPath);
+	std::ostream& out = outPath.empty() ? std::cout : file;
+
+	out << "{ \"scale\": " << scale << ", \"frames\": " << frames << ", \"store\": " << (store ? "true" : "false") << ", \"scenarios\": [";
+	bool first = true;
+
+	for (Scenario& s : scenarios()) {
+		if (!only.empty() and only != s.Name) continue;
+
+		Instance* root = new Instance(true);
+		auto buildStart = std::chrono::steady_clock::now();
+		int count = s.Build(root, scale);
+		double build = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - buildStart).count();
+
+		for (int f = 0; f < WARMUP; f++) {
+			s.Frame(f);
+			SUI_Step(*root);
+		}
+
+		Series phases[Profiler::PHASE_COUNT], total, allocs, bytes;
+		for (int f = 0; f < frames; f++) {
+			s.Frame(WARMUP + f);
+			unsigned long long allocsBefore = allocations, bytesBefore = allocatedBytes;
+			SUI_Step(*root);
+			allocs.Values.push_back((double)(allocations - allocsBefore));
+			bytes.Values.push_back((double)(allocatedBytes - bytesBefore));
+
+			const Profiler::FrameRecord& record = Profiler::Frame(0); // phases are exclusive, nested ones are not counted twice
+			total.Values.push_back(record.Total);
+			for (int p = 0; p < Profiler::PHASE_COUNT; p++) phases[p].Values.push_back(record.Phases[p]);
+		}
+
+		out << (first ? "" : ",") << "\n  { \"name\": \"" << s.Name << "\", \"objects\": " << count << ", \"build_ms\": " << build
+			<< ", \"draw_commands\": " << DrawList::Frame.size() << ",\n    \"frame_ms\": ";
+		total.write(out, 1000);
+		for (int p = 0; p < Profiler::PHASE_COUNT; p++) {
+			std::string name = Profiler::PhaseNames[p];
+			std::replace(name.begin(), name.end(), ' ', '_');
+			out << ",\n    \"" << name << "_ms\": "; phases[p].write(out, 1000);
+		}
+		out << ",\n    \"allocations\": "; allocs.write(out, 1);
+		out << ",\n    \"allocated_bytes\": "; bytes.write(out, 1);
+		out << " }";
+		first = false;
+
+		if (frames > 0) std::cerr << s.Name << ": " << count << " objects, median frame " << total.Values[total.Values.size() / 2] * 1000 << " ms" << std::endl;
+	}
+
+	out << "\n] }" << std::endl;
+	SUI_Close();
+	return 0;
+}
@@ -0,0 +1,106 @@
+// Type checks in a tree walk over ~200k instances: the old enum comparison chain and dynamic_cast
+// against the ClassTraits mask table. Every walk visits each node, finds its nearest Object2D
+// ancestor and reads ZIndex like updateChildren does. No window is opened.
+//
+// Build like any simpleUI program, e.g.:
+// g++ -std=c++20 -O2 -Iinclude benchmarks/type_dispatch.cpp -Llib -lraylib -lSUIutils -o type_dispatch
+
+#include <simpleUI.h>
+#include <chrono>
+
+constexpr int GROUPS = 20000;
+constexpr int RUNS = 30;
+
+bool legacyIs2DInheritor(Instance* obj) { // Is2DInheritor before the trait table
+	if (obj->Class == INSTANCE or
+		obj->Class == LINEEX or
+		obj->Class == STRING_VALUE or
+		obj->Class == BOOL_VALUE or
+		obj->Class == VECTOR2_VALUE or
+		obj->Class == INT_VALUE or
+		obj->Class == FLOAT_VALUE or
+		obj->Class == OBJECT_VALUE or
+		obj->Class == ADDRESS_VALUE or
+		obj->Class == COLOR_VALUE or
+		obj->Class == FOLDER
+		) {
+		return false;
+	}
+
+	return true;
+}
+
+long long legacyZ(Instance* obj) { // ZIndex lookup of the old updateChildren comparator
+	if (auto z = dynamic_cast<Object2D*>(obj)) return z->ZIndex;
+	if (obj->Class == LINEEX) {
+		if (auto z = dynamic_cast<LineEx*>(obj)) return z->ZIndex;
+	}
+	return 0;
+}
+
+long long traitZ(Instance* obj) {
+	unsigned char traits = ClassTraits[obj->Class];
+	if (!(traits & TRAIT_ZINDEX)) return 0;
+	if (traits & TRAIT_2D) return static_cast<Object2D*>(obj)->ZIndex;
+	return static_cast<LineEx*>(obj)->ZIndex;
+}
+
+template <bool Traits>
+long long walk(Instance* obj) {
+	long long sum = 0;
+	for (Instance* child : obj->Children) {
+		Instance* current = child->Parent;
+		while (current) {
+			if (Traits ? Is2DInheritor(current) : legacyIs2DInheritor(current)) break;
+			current = current->Parent;
+		}
+		sum += (current != nullptr) + (Traits ? traitZ(child) : legacyZ(child));
+		sum += walk<Traits>(child);
+	}
+	return sum;
+}
+
+template <typename F>
+double bestOf(F f) { // milliseconds, best run
+	double best = 1e30;
+	for (int r = 0; r < RUNS; r++) {
+		auto start = std::chrono::steady_clock::now();
+		f();
+		auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	return best;
+}
+
+int main() {
+	Instance* root = new Folder(nullptr);
+	Object2D* window = new Object2D(root);
+	int count = 2;
+
+	for (int g = 0; g < GROUPS; g++) { // 10 instances per group, 4 of them are not 2D
+		Object2D* panel = new Object2D(window);
+		panel->ZIndex = g % 3;
+		Folder* folder = new Folder(panel);
+		for (int i = 0; i < 4; i++) {
+			Object2D* item = new Object2D(i % 2 ? (Instance*)folder : (Instance*)panel);
+			item->ZIndex = i;
+		}
+		new IntValue(folder);
+		new BoolValue(panel);
+		LineEx* line = new LineEx(panel);
+		line->ZIndex = 1;
+		new Object2D(panel);
+		count += 10;
+	}
+
+	long long legacySum = 0, traitSum = 0;
+	double legacy = bestOf([&]() { legacySum = walk<false>(root); });
+	double traits = bestOf([&]() { traitSum = walk<true>(root); });
+
+	std::cout << count << " instances, best of " << RUNS << " runs, ms per walk" << std::endl;
+	std::cout << "enum chain + dynamic_cast: " << legacy << std::endl;
+	std::cout << "trait table:               " << traits << " (x" << legacy / traits << ")" << std::endl;
+	std::cout << (legacySum == traitSum ? "same results" : "RESULTS DIFFER") << std::endl;
+
+	return legacySum != traitSum;
+}
@@ -9,8 +9,18 @@
 #elif defined(__linux__)
 #include <X11/XKBlib.h>
 #include <gtk/gtk.h>
-inline Display* d = XOpenDisplay(nullptr);
-Window root = DefaultRootWindow(d);
+#endif
+#if !defined(_WIN32) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+static Display* display() { // opened on first use, headless machines have none
+	static Display* d = XOpenDisplay(nullptr);
+	return d;
+}
 #endif
 
 extern "C" const char* getLayout() {
@@ -22,6 +32,7 @@ extern "C" const char* getLayout() {
 		return "RU";
 	return "IDK";
 #elif defined(__linux__)
+	Display* d = display();
 	if (!d) return "EN";
 	XkbStateRec state;
 	XkbGetState(d, XkbUseCoreKbd, &state);
@@ -33,6 +44,7 @@ extern "C" bool capsLock() {
 #ifdef _WIN32
 	return (GetKeyState(VK_CAPITAL) & 0x0001) != 0;
 #elif defined(__linux__)
+	Display* d = display();
 	if (!d) return false;
 	unsigned int state = 0;
 	XkbGetIndicatorState(d, XkbUseCoreKbd, &state);
@@ -47,11 +59,13 @@ extern "C" float GetMouseScreenPositionX() {
 	GetCursorPos(&p);
 	return static_cast<float>(p.x);
 #elif defined(__linux__)
+	Display* d = display();
+	if (!d) return 0;
 	int root_x, root_y;
 	int win_x, win_y;
 	unsigned int mask;
 	Window child, root_return;
-	XQueryPointer(d, root, &root_return, &child, &root_x, &root_y, &win_x, &win_y, &mask);
+	XQueryPointer(d, DefaultRootWindow(d), &root_return, &child, &root_x, &root_y, &win_x, &win_y, &mask);
 	return (float)root_x;
 #endif
 }
@@ -62,11 +76,13 @@ extern "C" float GetMouseScreenPositionY() {
 	GetCursorPos(&p);
 	return static_cast<float>(p.y);
 #elif defined(__linux__)
+	Display* d = display();
+	if (!d) return 0;
 	int root_x, root_y;
 	int win_x, win_y;
 	unsigned int mask;
 	Window child, root_return;
-	XQueryPointer(d, root, &root_return, &child, &root_x, &root_y, &win_x, &win_y, &mask);
+	XQueryPointer(d, DefaultRootWindow(d), &root_return, &child, &root_x, &root_y, &win_x, &win_y, &mask);
 	return (float)root_y;
 #endif
 }
@@ -139,4 +155,57 @@ extern "C" const char* GetFile() {
 
 	return result.c_str();
 }
-#endif
\ No newline at end of file
+#endif
+
+extern "C" const void* MapFile(const char* path, unsigned long long* size, void** handle) {
+	*size = 0;
+	*handle = nullptr;
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return nullptr;
+
+	const void* view = nullptr;
+	LARGE_INTEGER length;
+	if (GetFileSizeEx(file, &length) && length.QuadPart > 0) {
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			if (view) {
+				*size = (unsigned long long)length.QuadPart;
+				*handle = mapping;
+			} else {
+				CloseHandle(mapping);
+			}
+		}
+	}
+	CloseHandle(file); // the mapping keeps the file open
+	return view;
+#elif defined(__unix__) || defined(__APPLE__)
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return nullptr;
+
+	const void* view = nullptr;
+	off_t length = lseek(fd, 0, SEEK_END);
+	if (length > 0) {
+		void* mapped = mmap(nullptr, (size_t)length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped != MAP_FAILED) {
+			view = mapped;
+			*size = (unsigned long long)length;
+		}
+	}
+	close(fd);
+	return view;
+#else
+	return nullptr;
+#endif
+}
+
+extern "C" void UnmapFile(const void* view, unsigned long long size, void* handle) {
+	if (!view) return;
+#ifdef _WIN32
+	UnmapViewOfFile(view);
+	if (handle) CloseHandle((HANDLE)handle);
+#elif defined(__unix__) || defined(__APPLE__)
+	munmap((void*)view, (size_t)size);
+#endif
+}
\ No newline at end of file
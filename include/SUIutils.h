@@ -25,6 +25,8 @@ extern "C" {
 #elif defined(__linux__)
     API const char* GetFile();
 #endif
+    API const void* MapFile(const char* path, unsigned long long* size, void** handle); // read only view of a whole file, null when it can not be mapped
+    API void UnmapFile(const void* view, unsigned long long size, void* handle);
 
 #ifdef __cplusplus
 }
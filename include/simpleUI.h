@@ -29,8 +29,12 @@
 
 namespace RAYLIB_FUNCTIONAL {
 #include <raylib.h>
+#include <rlgl.h>
 }
 
+#define GLFW_INCLUDE_NONE
+#include <glfw3.h>
+
 using RAYLIB_FUNCTIONAL::Vector2;
 using RAYLIB_FUNCTIONAL::Shader;
 using RAYLIB_FUNCTIONAL::Image;
@@ -52,22 +56,10 @@ using RAYLIB_FUNCTIONAL::SetTraceLogLevel;
 using RAYLIB_FUNCTIONAL::SetWindowSize;
 using RAYLIB_FUNCTIONAL::InitWindow;
 using RAYLIB_FUNCTIONAL::CloseWindow;
-using RAYLIB_FUNCTIONAL::GetWindowPosition;
-using RAYLIB_FUNCTIONAL::GetScreenWidth;
-using RAYLIB_FUNCTIONAL::GetScreenHeight;
-using RAYLIB_FUNCTIONAL::GetFrameTime;
-using RAYLIB_FUNCTIONAL::GetMousePosition;
 using RAYLIB_FUNCTIONAL::GetMonitorRefreshRate;
 using RAYLIB_FUNCTIONAL::GetCurrentMonitor;
-using RAYLIB_FUNCTIONAL::GetMouseWheelMove;
-using RAYLIB_FUNCTIONAL::IsKeyDown;
-using RAYLIB_FUNCTIONAL::IsKeyPressed;
-using RAYLIB_FUNCTIONAL::IsMouseButtonPressed;
-using RAYLIB_FUNCTIONAL::IsMouseButtonReleased;
 using RAYLIB_FUNCTIONAL::IsWindowMaximized;
 using RAYLIB_FUNCTIONAL::IsWindowReady;
-using RAYLIB_FUNCTIONAL::IsWindowFullscreen;
-using RAYLIB_FUNCTIONAL::WindowShouldClose;
 using RAYLIB_FUNCTIONAL::ToggleFullscreen;
 using RAYLIB_FUNCTIONAL::MaximizeWindow;
 using RAYLIB_FUNCTIONAL::MinimizeWindow;
@@ -78,10 +70,20 @@ using RAYLIB_FUNCTIONAL::SetTextureFilter;
 using RAYLIB_FUNCTIONAL::SetTextureWrap;
 
 using RAYLIB_FUNCTIONAL::LoadImage;
+using RAYLIB_FUNCTIONAL::LoadImageFromTexture;
+using RAYLIB_FUNCTIONAL::LoadImageFromScreen;
+using RAYLIB_FUNCTIONAL::ImageFlipVertical;
+using RAYLIB_FUNCTIONAL::ExportImage;
+using RAYLIB_FUNCTIONAL::LoadFileData;
+using RAYLIB_FUNCTIONAL::UnloadFileData;
+using RAYLIB_FUNCTIONAL::LoadFontData;
+using RAYLIB_FUNCTIONAL::GenImageFontAtlas;
 using RAYLIB_FUNCTIONAL::LoadImageFromMemory;
 using RAYLIB_FUNCTIONAL::LoadTextureFromImage;
+using RAYLIB_FUNCTIONAL::GetPixelDataSize;
 using RAYLIB_FUNCTIONAL::LoadShader;
 using RAYLIB_FUNCTIONAL::LoadCodepoints;
+using RAYLIB_FUNCTIONAL::GetCodepointNext;
 using RAYLIB_FUNCTIONAL::LoadFontEx;
 using RAYLIB_FUNCTIONAL::LoadRenderTexture;
 
@@ -99,15 +101,27 @@ using RAYLIB_FUNCTIONAL::EndShaderMode;
 using RAYLIB_FUNCTIONAL::BeginDrawing;
 using RAYLIB_FUNCTIONAL::EndDrawing;
 
+using RAYLIB_FUNCTIONAL::rlRenderBatch;
+using RAYLIB_FUNCTIONAL::rlLoadRenderBatch;
+using RAYLIB_FUNCTIONAL::rlUnloadRenderBatch;
+using RAYLIB_FUNCTIONAL::rlSetRenderBatchActive;
+using RAYLIB_FUNCTIONAL::rlDrawRenderBatchActive;
+using RAYLIB_FUNCTIONAL::rlEnableColorBlend;
+using RAYLIB_FUNCTIONAL::rlDisableColorBlend;
+using RAYLIB_FUNCTIONAL::rlLoadTexture;
+
 using RAYLIB_FUNCTIONAL::TEXTURE_FILTER_TRILINEAR;
 using RAYLIB_FUNCTIONAL::TEXTURE_WRAP_CLAMP;
 
 using RAYLIB_FUNCTIONAL::FLAG_WINDOW_UNDECORATED;
 using RAYLIB_FUNCTIONAL::FLAG_WINDOW_RESIZABLE;
+using RAYLIB_FUNCTIONAL::FLAG_WINDOW_HIDDEN;
 
 using RAYLIB_FUNCTIONAL::PIXELFORMAT_UNCOMPRESSED_R8G8B8;
 using RAYLIB_FUNCTIONAL::PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+using RAYLIB_FUNCTIONAL::PIXELFORMAT_COMPRESSED_DXT1_RGB;
 
+using RAYLIB_FUNCTIONAL::MouseButton;
 using RAYLIB_FUNCTIONAL::MOUSE_BUTTON_LEFT;
 using RAYLIB_FUNCTIONAL::MOUSE_BUTTON_RIGHT;
 using RAYLIB_FUNCTIONAL::MOUSE_BUTTON_MIDDLE;
@@ -125,6 +139,7 @@ using RAYLIB_FUNCTIONAL::MOUSE_CURSOR_RESIZE_NS;
 using RAYLIB_FUNCTIONAL::MOUSE_CURSOR_IBEAM;
 
 using RAYLIB_FUNCTIONAL::LOG_NONE;
+using RAYLIB_FUNCTIONAL::FONT_DEFAULT;
 
 using RAYLIB_FUNCTIONAL::KeyboardKey;
 using RAYLIB_FUNCTIONAL::KEY_LEFT_SHIFT;
@@ -198,13 +213,262 @@ using RAYLIB_FUNCTIONAL::SHADER_UNIFORM_VEC4;
 #include <sstream>
 #include <functional>
 #include <unordered_map>
+#include <unordered_set>
 #include <set>
+#include <map>
 #include <tuple>
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <limits>
+#include <array>
+#include <chrono>
+#if defined(__AVX__) or defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+#include <immintrin.h>
+#endif
+
+// Headless runs for CI and benchmarks. HEADLESS_NULL opens no window and has no GL at all: nothing is uploaded,
+// draw calls are only recorded by the DrawList. HEADLESS_OFFSCREEN renders into a hidden window, so it still needs
+// a GL driver (a software one like Mesa llvmpipe under Xvfb is enough). In both modes input comes from the
+// SUI_Inject* functions and time only advances with SUI_Step.
+enum HeadlessMode { HEADLESS_OFF, HEADLESS_NULL, HEADLESS_OFFSCREEN };
+inline HeadlessMode HEADLESS = HEADLESS_OFF;
+
+inline bool hasRenderer() { // false when there is no GL context to upload to or draw into
+	return HEADLESS != HEADLESS_NULL;
+}
+
+namespace Input { // injected state, used instead of the window's in headless mode
+	constexpr int KEYS = 512;
+	constexpr int BUTTONS = 8;
+
+	inline bool Keys[KEYS]{}, previousKeys[KEYS]{};
+	inline bool Buttons[BUTTONS]{}, previousButtons[BUTTONS]{};
+	inline Vector2 Mouse{};
+	inline float Wheel = 0;
+	inline float FrameTime = 1.0f / 60;
+	inline double Time = 0;
+	inline int Width = 0, Height = 0;
+
+	inline bool key(const bool* state, int key) { return key >= 0 and key < KEYS and state[key]; }
+	inline bool button(const bool* state, int button) { return button >= 0 and button < BUTTONS and state[button]; }
+
+	inline void endFrame() {
+		std::memcpy(previousKeys, Keys, sizeof(Keys));
+		std::memcpy(previousButtons, Buttons, sizeof(Buttons));
+		Wheel = 0;
+	}
+}
+
+inline bool headless() { return HEADLESS != HEADLESS_OFF; }
+
+// Window and input queries go through here so headless runs can answer them. The enum overloads are
+// exact matches for raylib's own enum arguments, otherwise ADL would pick the raylib functions directly.
+inline bool IsKeyDown(int key) { return headless() ? Input::key(Input::Keys, key) : RAYLIB_FUNCTIONAL::IsKeyDown(key); }
+inline bool IsKeyDown(KeyboardKey key) { return IsKeyDown((int)key); }
+inline bool IsKeyPressed(int key) {
+	if (!headless()) return RAYLIB_FUNCTIONAL::IsKeyPressed(key);
+	return Input::key(Input::Keys, key) and !Input::key(Input::previousKeys, key);
+}
+inline bool IsKeyPressed(KeyboardKey key) { return IsKeyPressed((int)key); }
+inline bool IsMouseButtonPressed(int button) {
+	if (!headless()) return RAYLIB_FUNCTIONAL::IsMouseButtonPressed(button);
+	return Input::button(Input::Buttons, button) and !Input::button(Input::previousButtons, button);
+}
+inline bool IsMouseButtonPressed(MouseButton button) { return IsMouseButtonPressed((int)button); }
+inline bool IsMouseButtonReleased(int button) {
+	if (!headless()) return RAYLIB_FUNCTIONAL::IsMouseButtonReleased(button);
+	return !Input::button(Input::Buttons, button) and Input::button(Input::previousButtons, button);
+}
+inline bool IsMouseButtonReleased(MouseButton button) { return IsMouseButtonReleased((int)button); }
+inline Vector2 GetMousePosition() { return headless() ? Input::Mouse : RAYLIB_FUNCTIONAL::GetMousePosition(); }
+inline float GetMouseWheelMove() { return headless() ? Input::Wheel : RAYLIB_FUNCTIONAL::GetMouseWheelMove(); }
+inline int GetScreenWidth() { return headless() ? Input::Width : RAYLIB_FUNCTIONAL::GetScreenWidth(); }
+inline int GetScreenHeight() { return headless() ? Input::Height : RAYLIB_FUNCTIONAL::GetScreenHeight(); }
+inline Vector2 GetWindowPosition() { return headless() ? Vector2{} : RAYLIB_FUNCTIONAL::GetWindowPosition(); }
+inline bool WindowShouldClose() { return headless() ? false : RAYLIB_FUNCTIONAL::WindowShouldClose(); }
+inline bool IsWindowFullscreen() { return headless() ? false : RAYLIB_FUNCTIONAL::IsWindowFullscreen(); }
+inline float GetFrameTime() { return headless() ? Input::FrameTime : RAYLIB_FUNCTIONAL::GetFrameTime(); }
+inline double GetTime() { return headless() ? Input::Time : RAYLIB_FUNCTIONAL::GetTime(); }
+
+#ifndef SUI_PROFILER // 0 compiles the profiler scopes out, Profiler::Enabled switches them off at runtime
+#define SUI_PROFILER 1
+#endif
+
+#if SUI_PROFILER
+#define SUI_PROFILE(phase) Profiler::Scope profilerScope(phase)
+#define SUI_PROFILE_IF(phase, condition) Profiler::Scope profilerScope(phase, condition)
+#define SUI_PROFILE_OBJECT(obj) Profiler::ObjectScope objectScope(obj)
+#define SUI_COUNT_COST(obj, counter) if (Profiler::ObjectCosts) (obj)->frameCost().counter++
+#else
+#define SUI_PROFILE(phase)
+#define SUI_PROFILE_IF(phase, condition)
+#define SUI_PROFILE_OBJECT(obj)
+#define SUI_COUNT_COST(obj, counter)
+#endif
+
+class Instance;
+
+namespace Profiler { // time of every frame split into phases, shown in the debug menu and exportable as a Chrome trace
+	enum Phase : unsigned char {
+		PHASE_SIGNALS = 0,
+		PHASE_ANIMATIONS,
+		PHASE_TASKS,
+		PHASE_HIT_TEST, // UpdateHigher
+		PHASE_LAYOUT,
+		PHASE_EVENTS, // object event handlers
+		PHASE_TEXT, // text texture regeneration
+		PHASE_DRAW,
+		PHASE_PRESENT,
+		PHASE_COUNT
+	};
+
+	inline const char* PhaseNames[PHASE_COUNT] = { "signals", "animations", "tasks", "hit test", "layout", "events", "text", "draw", "present" };
+	inline Color PhaseColors[PHASE_COUNT] = {
+		{ 255,204,102,255 }, { 255,153,204,255 }, { 204,153,255,255 }, { 255,102,102,255 }, { 102,204,255,255 },
+		{ 255,255,102,255 }, { 153,255,153,255 }, { 51,153,255,255 }, { 153,153,153,255 }
+	};
+
+	struct FrameRecord {
+		double Start = 0;
+		double Total = 0; // without the time spent waiting for events
+		double Phases[PHASE_COUNT]{}; // exclusive, a nested phase is not counted in the one around it
+		int Calls[PHASE_COUNT]{};
+		int MetricsHits = 0; // lookups of MetricsCache
+		int MetricsMisses = 0;
+	};
+
+	struct TraceEvent {
+		Phase Type;
+		double Start;
+		double Duration;
+	};
+
+	constexpr int HISTORY = 240;
+	constexpr int MAX_DEPTH = 64;
+
+	inline bool Enabled = true;
+	inline size_t MaxTraceEvents = 1 << 18; // nested scopes past it are dropped from a capture, the phases of a frame are always kept
+	inline bool ObjectCosts = false; // per object counters of Instance::frameCost, on while the debug menu is open
+	inline FrameRecord History[HISTORY]{};
+	inline int historyEnd = 0; // slot the next finished frame goes to
+	inline FrameRecord current{};
+	inline bool inFrame = false;
+
+	inline Phase stack[MAX_DEPTH];
+	inline int depth = 0;
+
+	inline std::vector<TraceEvent> traceEvents;
+	inline std::vector<FrameRecord> traceFrames;
+	inline unsigned long long traceDropped = 0;
+	inline int traceFramesLeft = 0;
+	inline std::string tracePath;
+
+	inline double now() {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	struct Scope {
+		Phase Type;
+		bool Active;
+		double Start = 0;
+
+		Scope(Phase type, bool active = true) : Type(type), Active(active and Enabled and inFrame and depth < MAX_DEPTH) {
+			if (!Active) return;
+			stack[depth++] = type;
+			Start = now();
+		}
+
+		~Scope() {
+			if (!Active) return;
+			double duration = now() - Start;
+			depth--;
+			current.Phases[Type] += duration;
+			current.Calls[Type]++;
+			if (depth > 0) current.Phases[stack[depth - 1]] -= duration;
+			if (traceFramesLeft > 0) {
+				if (depth == 0 or traceEvents.size() < MaxTraceEvents) traceEvents.push_back({ Type, Start, duration });
+				else traceDropped++;
+			}
+		}
+	};
+
+	struct ObjectScope { // time of one Update including the children, defined after Instance
+		Instance* Obj = nullptr;
+		double Start = 0;
+
+		ObjectScope(Instance* obj);
+		~ObjectScope();
+	};
+
+	inline const FrameRecord& Frame(int age) { // 0 is the last finished frame
+		return History[((historyEnd - 1 - age) % HISTORY + HISTORY) % HISTORY];
+	}
+
+	inline bool WriteTrace(const std::string& path) { // Chrome trace event format, opens in chrome://tracing or Perfetto
+		std::ofstream out(path);
+		if (!out) return false;
+
+		double origin = traceFrames.empty() ? 0 : traceFrames.front().Start;
+		out << "{ \"traceEvents\": [";
+		bool first = true;
+		for (size_t i = 0; i < traceFrames.size(); i++) {
+			out << (first ? "" : ",") << "\n{ \"name\": \"frame " << i << "\", \"cat\": \"frame\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": "
+				<< (traceFrames[i].Start - origin) * 1e6 << ", \"dur\": " << traceFrames[i].Total * 1e6 << " }";
+			out << ",\n{ \"name\": \"text metrics\", \"ph\": \"C\", \"pid\": 1, \"ts\": " << (traceFrames[i].Start - origin) * 1e6
+				<< ", \"args\": { \"hits\": " << traceFrames[i].MetricsHits << ", \"misses\": " << traceFrames[i].MetricsMisses << " } }";
+			first = false;
+		}
+		for (const TraceEvent& e : traceEvents) {
+			out << ",\n{ \"name\": \"" << PhaseNames[e.Type] << "\", \"cat\": \"simpleUI\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": "
+				<< (e.Start - origin) * 1e6 << ", \"dur\": " << e.Duration * 1e6 << " }";
+		}
+		out << "\n], \"displayTimeUnit\": \"ms\", \"otherData\": { \"dropped_events\": " << traceDropped << " } }" << std::endl;
+		return true;
+	}
+
+	inline void CaptureTrace(const std::string& path, int frames) { // records the next frames and writes them to path
+		traceEvents.clear();
+		traceFrames.clear();
+		traceDropped = 0;
+		tracePath = path;
+		traceFramesLeft = frames;
+	}
+
+	inline void BeginFrame() {
+		current = FrameRecord{};
+		current.Start = now();
+		inFrame = true;
+	}
+
+	inline void EndFrame() {
+		if (!inFrame) return;
+		inFrame = false;
+		current.Total = now() - current.Start;
+		History[historyEnd] = current;
+		historyEnd = (historyEnd + 1) % HISTORY;
+
+		if (traceFramesLeft > 0) {
+			traceFrames.push_back(current);
+			if (--traceFramesLeft == 0) {
+				if (!WriteTrace(tracePath)) std::cout << "Profiler: could not write " << tracePath << std::endl;
+				else if (traceDropped) std::cout << "Profiler: " << traceDropped << " nested events over MaxTraceEvents were dropped" << std::endl;
+				traceEvents.clear();
+				traceEvents.shrink_to_fit();
+				traceFrames.clear();
+			}
+		}
+	}
+}
 
 class Object2D;
 
@@ -260,6 +524,12 @@ struct SpecialVector2 {
 
 	SpecialVector2(const Vector2& other) : x{ other.x }, y{ other.y } {}
 
+	SpecialVector2(const SpecialVector2& other) : x{ other.x.n }, y{ other.y.n } {} // only value is copied, parentalObj stays with the object which owns the vector
+
+	SpecialVector2& operator=(const SpecialVector2& other) {
+		return *this = Vector2{ other.x.n, other.y.n };
+	}
+
 	operator Vector2() const {
 		return { x.n, y.n };
 	}
@@ -298,66 +568,536 @@ inline constexpr const char* BASIC_FONT_NAME = "Arial";
 inline constexpr const char* DEBUG_MENU_FONT_NAME = "rog";
 inline std::unordered_map<std::string, Shader> Shaders;
 inline long currentUniqueObjectID = 0;
+inline unsigned int layoutEpoch = 0; // changes with window size, every cached layout becomes invalid
+
+namespace LayoutStore { // optional flat copy of Object2D geometry, laid out in one linear sweep before the tree is updated
+	inline bool Enabled = false;
+	inline bool structureDirty = true; // tree was changed, node order has to be built again
+	inline bool valuesDirty = true;
+	inline int Threads = 1; // threads solving independent subtrees, see SUI_SetLayoutThreads
+
+	inline void write(Object2D* obj);
+	inline void forget(Object2D* obj);
+}
+
+namespace HitIndex { // uniform grid over the root tree used by UpdateHigher, ScrollFrame content is found by its sectors
+	inline bool Enabled = true;
+	inline bool structureDirty = true; // root or window changed, every entry has to be numbered again
+
+	inline void moved(Object2D* obj);
+	inline void forget(Object2D* obj);
+	inline void changed(Instance* parent);
+	inline void discard(Instance* obj);
+}
 bool sceneDirty = false; // true in frame where any object size or position changed
+inline bool tickedInFrame = false; // some TICK event was called in this frame
+inline std::atomic<bool> frameRequested = false;
+inline float nextFrameIn = -1; // shortest delay after which some object wants to be updated again, -1 if none
 
-inline std::mutex ImagesLoadingMtx;
-inline std::unordered_map<std::string, std::pair<Image, Texture>> loadedImages;
-inline std::unordered_map<std::string, Image> pendingImages;
-inline void loadImage(const std::string& name, const std::string& path) {
-	ImagesLoadingMtx.lock();
+// Loop sleeps while nothing is animated, ticking or changing and wakes up on input,
+// a task deadline or SUI_RequestFrame(). Off by default.
+inline bool WAIT_FOR_EVENTS = false;
+
+void SUI_WaitForEvents(bool enabled) {
+	WAIT_FOR_EVENTS = enabled;
+}
+
+void SUI_RequestFrame() { // safe to call from any thread
+	frameRequested = true;
+	if (WAIT_FOR_EVENTS) glfwPostEmptyEvent();
+}
+
+inline void requestFrameIn(float seconds) {
+	if (seconds < 0) seconds = 0;
+	if (nextFrameIn < 0 or seconds < nextFrameIn) nextFrameIn = seconds;
+}
 
-	if (pendingImages.find(name) != pendingImages.end()) {
-		ImagesLoadingMtx.unlock();
-		std::cout << "Image: " << name << " already exists" << std::endl; 
-		return; 
+namespace DrawList {
+	inline void ReleaseTexture(unsigned int id);
+	inline void TextureChanged(unsigned int id);
+}
+
+// Node of MPSCQueue, the queued type derives from it
+struct MPSCNode {
+	std::atomic<MPSCNode*> Next{ nullptr };
+};
+
+// Lock-free queue with many producers and one consumer (Vyukov): push is one exchange, pop is only
+// called from the consuming thread and returns nullptr while a push is half done.
+template <typename T>
+class MPSCQueue {
+	std::atomic<MPSCNode*> head;
+	MPSCNode* tail;
+	MPSCNode stub;
+
+public:
+	MPSCQueue() : head(&stub), tail(&stub) {}
+
+	void push(T* item) {
+		MPSCNode* node = item;
+		node->Next.store(nullptr, std::memory_order_relaxed);
+		MPSCNode* previous = head.exchange(node, std::memory_order_acq_rel);
+		previous->Next.store(node, std::memory_order_release);
+	}
+
+	T* pop() {
+		MPSCNode* first = tail;
+		MPSCNode* next = first->Next.load(std::memory_order_acquire);
+		if (first == &stub) {
+			if (!next) return nullptr;
+			tail = next;
+			first = next;
+			next = next->Next.load(std::memory_order_acquire);
+		}
+		if (next) {
+			tail = next;
+			return static_cast<T*>(first);
+		}
+		if (first != head.load(std::memory_order_acquire)) return nullptr;
+
+		stub.Next.store(nullptr, std::memory_order_relaxed);
+		MPSCNode* previous = head.exchange(&stub, std::memory_order_acq_rel);
+		previous->Next.store(&stub, std::memory_order_release);
+		next = first->Next.load(std::memory_order_acquire);
+		if (next) {
+			tail = next;
+			return static_cast<T*>(first);
+		}
+		return nullptr;
 	}
+};
 
-	Image img = LoadImage(path.c_str());
-	if (!img.data) {
-		ImagesLoadingMtx.unlock();
-		std::cout << "Image: " << name << " error while loading" << std::endl;
-		return;
+class ImageLabel;
+
+// Images are decoded by worker threads and uploaded on the render thread in steps, a few milliseconds per frame
+// (see SUI_SetImageUploadBudget). loadImage may be called from any thread, the maps below belong to the render thread.
+namespace ImageLoader {
+	inline int Threads = 2; // decode workers, started by the first loadImage
+	inline double UploadBudget = 0.004; // seconds of upload steps per frame, one step is always done
+	inline int StripBytes = 1 << 20; // pixels uploaded by one step, big images take several frames
+	inline int MinTierSize = 32; // halved copies are made while both sides stay at least this long
+
+	struct Request {
+		std::string Name, Path;
+		unsigned long long Id;
+		int Tier; // first copy to make, tier n is the image halved n times
+	};
+
+	struct Decoded : MPSCNode {
+		std::string Name, Path;
+		std::vector<Image> Tiers; // Tier, Tier + 1, ..., the larger ones are never kept
+		int Tier = 0;
+		int Width = 0, Height = 0; // of the file
+		unsigned long long Id = 0;
+	};
+
+	inline void makeTiers(Decoded& result, Image img) { // on a worker, the file is decoded again when a larger tier is needed
+		result.Width = img.width;
+		result.Height = img.height;
+		bool resizable = img.mipmaps == 1 and img.format < PIXELFORMAT_COMPRESSED_DXT1_RGB;
+		result.Tier = resizable ? std::clamp(result.Tier, 0, std::max(0, (int)std::log2(std::max(1, std::min(img.width, img.height) / MinTierSize)))) : 0;
+		if (result.Tier) ImageResize(&img, std::max(1, img.width >> result.Tier), std::max(1, img.height >> result.Tier));
+		result.Tiers.push_back(img);
+
+		while (resizable and img.width / 2 >= MinTierSize and img.height / 2 >= MinTierSize) {
+			img = ImageCopy(img);
+			ImageResize(&img, img.width / 2, img.height / 2);
+			result.Tiers.push_back(img);
+		}
+	}
+
+	// Pre-decoded tiers on disk, one file per source path in CacheDir (empty turns it off). A file is valid while the
+	// source keeps its size and modification time; warm loads copy the needed tiers out of it instead of decoding.
+	// Files are mapped by SUIutils (MapViewOfFile on Windows, mmap elsewhere) and read with a stream when that fails.
+	// See SUI_BuildImageCache.
+	inline std::string CacheDir;
+	inline bool WriteCache = true; // files decoded at full size are written to CacheDir
+	inline std::atomic<unsigned long long> CacheHits{ 0 }, CacheMisses{ 0 };
+
+	struct CacheHeader {
+		char Magic[4] = { 'S', 'U', 'I', 'C' };
+		uint32_t Version = 1;
+		uint64_t SourceSize = 0;
+		int64_t SourceTime = 0;
+		int32_t Width = 0, Height = 0; // of the file
+		int32_t Format = 0, Tiers = 0;
+		uint32_t PathLength = 0; // the source path follows the header, then the tier table and the pixels
+	};
+
+	struct CacheTier {
+		int32_t Width, Height;
+		uint64_t Offset, Bytes;
+	};
+
+	class CacheFile { // read only view of a whole file
+	public:
+		explicit CacheFile(const std::string& path) {
+			data = (const unsigned char*)MapFile(path.c_str(), &length_, &handle);
+			if (data) return;
+			stream.open(path, std::ios::binary | std::ios::ate);
+			if (stream) length_ = (unsigned long long)stream.tellg();
+		}
+
+		~CacheFile() {
+			if (data) UnmapFile(data, length_, handle);
+		}
+
+		CacheFile(const CacheFile&) = delete;
+		CacheFile& operator=(const CacheFile&) = delete;
+
+		uint64_t size() const { return length_; }
+
+		bool read(uint64_t offset, void* destination, uint64_t bytes) {
+			if (offset > length_ or bytes > length_ - offset) return false;
+			if (data) {
+				std::memcpy(destination, data + offset, (size_t)bytes);
+				return true;
+			}
+			stream.seekg((std::streamoff)offset);
+			return (bool)stream.read((char*)destination, (std::streamsize)bytes);
+		}
+
+	private:
+		unsigned long long length_ = 0;
+		const unsigned char* data = nullptr;
+		void* handle = nullptr; // of the mapping, Windows only
+		std::ifstream stream;
+	};
+
+	struct CacheKey {
+		std::string Source; // absolute path
+		std::string File; // in CacheDir
+		uint64_t Size = 0;
+		int64_t Time = 0;
+	};
+
+	inline bool cacheKey(const std::string& path, CacheKey& key) { // false when the source can not be found
+		if (CacheDir.empty()) return false;
+		std::error_code error;
+		std::filesystem::path source = std::filesystem::absolute(path, error).lexically_normal();
+		if (error) return false;
+		key.Size = std::filesystem::file_size(source, error);
+		if (error) return false;
+		key.Time = std::filesystem::last_write_time(source, error).time_since_epoch().count();
+		if (error) return false;
+		key.Source = source.string();
+
+		uint64_t hash = 14695981039346656037ull; // FNV-1a, stable between runs and compilers
+		for (unsigned char c : key.Source) hash = (hash ^ c) * 1099511628211ull;
+		char name[24];
+		std::snprintf(name, sizeof(name), "%016llx.suic", (unsigned long long)hash);
+		key.File = (std::filesystem::path(CacheDir) / name).string();
+		return true;
+	}
+
+	inline bool readCache(Decoded& result, const CacheKey& key) { // tiers from result.Tier on, or false to decode
+		CacheFile file(key.File);
+		CacheHeader header;
+		if (!file.read(0, &header, sizeof(header)) or std::memcmp(header.Magic, CacheHeader().Magic, 4) or header.Version != CacheHeader().Version
+			or header.SourceSize != key.Size or header.SourceTime != key.Time or header.PathLength != key.Source.size()
+			or header.Tiers <= 0 or header.Tiers > 32) return false;
+
+		std::string source(header.PathLength, '\0');
+		std::vector<CacheTier> table(header.Tiers);
+		if (!file.read(sizeof(header), source.data(), source.size()) or source != key.Source
+			or !file.read(sizeof(header) + source.size(), table.data(), table.size() * sizeof(CacheTier))) return false;
+
+		int first = std::clamp(result.Tier, 0, header.Tiers - 1);
+		std::vector<Image> tiers;
+		for (int i = first; i < header.Tiers; i++) {
+			const CacheTier& tier = table[i];
+			Image img{ nullptr, tier.Width, tier.Height, 1, header.Format };
+			if (tier.Width <= 0 or tier.Height <= 0 or tier.Bytes != (uint64_t)GetPixelDataSize(tier.Width, tier.Height, header.Format)) break;
+			img.data = RL_MALLOC((size_t)tier.Bytes);
+			if (!img.data or !file.read(tier.Offset, img.data, tier.Bytes)) {
+				if (img.data) RL_FREE(img.data);
+				break;
+			}
+			tiers.push_back(img);
+		}
+		if ((int)tiers.size() != header.Tiers - first) {
+			for (Image& img : tiers) UnloadImage(img);
+			return false;
+		}
+
+		result.Width = header.Width;
+		result.Height = header.Height;
+		result.Tier = first;
+		result.Tiers = std::move(tiers);
+		return true;
+	}
+
+	inline bool writeCache(const Decoded& result, const CacheKey& key) { // needs the whole chain, from tier 0
+		if (result.Tier != 0 or result.Tiers.empty()) return false;
+		for (const Image& img : result.Tiers) {
+			if (img.mipmaps != 1 or img.format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) return false;
+		}
+
+		CacheHeader header;
+		header.SourceSize = key.Size;
+		header.SourceTime = key.Time;
+		header.Width = result.Width;
+		header.Height = result.Height;
+		header.Format = result.Tiers[0].format;
+		header.Tiers = (int32_t)result.Tiers.size();
+		header.PathLength = (uint32_t)key.Source.size();
+
+		std::vector<CacheTier> table;
+		uint64_t offset = sizeof(header) + key.Source.size() + result.Tiers.size() * sizeof(CacheTier);
+		for (const Image& img : result.Tiers) {
+			offset = (offset + 63) & ~63ull; // rows of every tier start on a cache line
+			uint64_t bytes = (uint64_t)GetPixelDataSize(img.width, img.height, img.format);
+			table.push_back({ img.width, img.height, offset, bytes });
+			offset += bytes;
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories(CacheDir, error);
+		static std::atomic<unsigned long long> temporaries{ 0 }; // workers writing the same file do not share the temporary
+		std::string temporary = key.File + "." + std::to_string(temporaries++) + ".tmp";
+		{
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			if (!out) return false;
+			out.write((const char*)&header, sizeof(header));
+			out.write(key.Source.data(), key.Source.size());
+			out.write((const char*)table.data(), table.size() * sizeof(CacheTier));
+			for (size_t i = 0; i < table.size(); i++) {
+				static const char padding[64] = {};
+				out.write(padding, table[i].Offset - (uint64_t)out.tellp());
+				out.write((const char*)result.Tiers[i].data, table[i].Bytes);
+			}
+			if (!out) {
+				out.close();
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+		}
+		std::filesystem::rename(temporary, key.File, error); // readers see the old file or the whole new one
+		if (error) std::filesystem::remove(temporary, error);
+		return !error;
+	}
+
+	inline bool loadTiers(Decoded& result) { // from the cache file when it is valid, else decoded and cached
+		CacheKey key;
+		bool cached = cacheKey(result.Path, key);
+		if (cached and readCache(result, key)) {
+			CacheHits++;
+			return true;
+		}
+		if (cached) CacheMisses++;
+
+		Image img = LoadImage(result.Path.c_str());
+		if (!img.data) return false;
+		makeTiers(result, img);
+		if (cached and WriteCache) writeCache(result, key);
+		return true;
+	}
+
+	struct CacheReport { // of SUI_BuildImageCache, seconds are summed over the files
+		int Built = 0, Current = 0, Failed = 0;
+		double DecodeSeconds = 0; // decoding and halving the built files
+		double MappedSeconds = 0; // reading every file back from the cache
+	};
+
+	inline std::mutex requestsMtx; // guards the request queue and the requested names, never held while decoding
+	inline std::condition_variable requestsWake;
+	inline std::deque<Request> requests;
+	inline std::unordered_map<std::string, unsigned long long> requested; // names loaded or on the way, by request id
+	inline unsigned long long nextId = 1;
+	inline std::vector<std::thread> workers;
+	inline bool stopping = false;
+
+	inline MPSCQueue<Decoded> decoded;
+
+	struct UploadJob { // rows are uploaded in strips, mipmaps are the last step
+		std::string Name;
+		std::vector<Image> Tiers; // of the Decoded, the one fitting the labels is uploaded when the job starts
+		int FirstTier = 0;
+		int Tier = -1;
+		Image Img{};
+		Texture Tex{};
+		int Rows = 0;
+	};
+
+	inline std::vector<UploadJob> uploads; // of pendingImages, in the order they were decoded
+	inline std::unordered_map<std::string, float> wanted; // largest area on screen of labels waiting for an image in the last frame
+
+	inline void want(const std::string& name, float area) {
+		float& largest = wanted[name];
+		largest = std::max(largest, area);
+	}
+
+	inline void workerLoop() {
+		while (true) {
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(requestsMtx);
+				requestsWake.wait(lock, []() { return stopping or requests.size(); });
+				if (stopping) return;
+				request = std::move(requests.front());
+				requests.pop_front();
+			}
+
+			Decoded* result = new Decoded();
+			result->Name = std::move(request.Name);
+			result->Path = std::move(request.Path);
+			result->Id = request.Id;
+			result->Tier = request.Tier;
+			if (!loadTiers(*result)) std::cout << "Image: " << result->Name << " error while loading" << std::endl;
+			decoded.push(result);
+			SUI_RequestFrame();
+		}
+	}
+
+	inline void decode(const std::string& name, const std::string& path, bool reload, int tier = 0) { // a reload keeps the request of the name
+		{
+			std::lock_guard<std::mutex> lock(requestsMtx);
+			auto it = requested.find(name);
+			if (reload) {
+				if (it == requested.end()) return; // unloaded
+			} else {
+				if (it != requested.end()) {
+					std::cout << "Image: " << name << " already exists" << std::endl;
+					return;
+				}
+				it = requested.emplace(name, nextId++).first;
+			}
+
+			if (reload) requests.push_front({ name, path, it->second, tier }); // a label on screen waits for it
+			else requests.push_back({ name, path, it->second, tier });
+			if (workers.empty()) {
+				for (int i = 0; i < std::max(1, Threads); i++) workers.emplace_back(workerLoop);
+			}
+		}
+		requestsWake.notify_one();
+	}
+
+	inline bool current(const std::string& name, unsigned long long id) { // not unloaded or requested again since
+		std::lock_guard<std::mutex> lock(requestsMtx);
+		auto it = requested.find(name);
+		return it != requested.end() and it->second == id;
+	}
+
+	inline void Stop() {
+		{
+			std::lock_guard<std::mutex> lock(requestsMtx);
+			stopping = true;
+		}
+		requestsWake.notify_all();
+		for (std::thread& worker : workers) worker.join();
+		workers.clear();
+		stopping = false;
+
+		while (Decoded* result = decoded.pop()) {
+			for (Image& img : result->Tiers) UnloadImage(img);
+			delete result;
+		}
 	}
 
-	pendingImages.insert({ name, img });
-	ImagesLoadingMtx.unlock();
+	inline struct StopAtExit { // joins the workers when the program ends without closeWindow
+		~StopAtExit() { Stop(); }
+	} stopAtExit;
 }
 
-inline void unloadImage(const std::string& name) {
-	ImagesLoadingMtx.lock();
+inline std::unordered_map<std::string, std::pair<Image, Texture>> loadedImages;
 
-	auto it = loadedImages.find(name);
-	if (it != loadedImages.end()) {
-		UnloadImage(it->second.first);
-		UnloadTexture(it->second.second);
-		loadedImages.erase(it);
+// Entries of the images that were loaded, with the ImageLabels using them. Textures over VRAMBudget are evicted
+// least recently drawn first and decoded again from their path when a label shows them.
+namespace ImageCache {
+	inline size_t VRAMBudget = 512ull << 20; // bytes of image textures
+	inline size_t EvictAfterFrames = 120; // textures drawn in the last frames are kept even over the budget
+	inline bool KeepImages = false; // the decoded Image stays in RAM after the upload, getImage then returns it
+	inline size_t Used = 0; // bytes of image textures
+	inline size_t Frame = 0;
+	inline unsigned long long Hits = 0; // getImage found a texture
+	inline unsigned long long Misses = 0;
+	inline unsigned long long Evictions = 0;
+	inline unsigned long long Reloads = 0;
+	inline unsigned long long Upgrades = 0; // larger tiers decoded because a label grew
+
+	struct Entry {
+		std::string Path; // empty until the image was decoded
+		std::vector<ImageLabel*> Labels; // showing or waiting for the image
+		size_t Bytes = 0; // of the texture, 0 while it is not uploaded
+		size_t LastUsed = 0; // frame in which the texture was drawn
+		bool Loading = false; // decoded again after an eviction or for a larger label
+		int Tier = 0; // of the texture
+		int Width = 0, Height = 0; // of the file
+	};
+
+	inline std::unordered_map<std::string, Entry> entries;
+
+	inline void acquire(const std::string& name, ImageLabel* label) {
+		if (name != "") entries[name].Labels.push_back(label);
 	}
 
-	auto it1 = pendingImages.find(name);
-	if (it1 != pendingImages.end()) {
-		UnloadImage(it1->second);
-		pendingImages.erase(it1);
+	inline void release(const std::string& name, ImageLabel* label) {
+		auto it = entries.find(name);
+		if (it == entries.end()) return;
+		std::erase(it->second.Labels, label);
+		if (it->second.Labels.empty() and it->second.Path.empty()) entries.erase(it);
+	}
+
+	inline void touch(const std::string& name) {
+		auto it = entries.find(name);
+		if (it != entries.end()) it->second.LastUsed = Frame;
+	}
+
+	inline int tierFor(float width, float height, const Entry& entry) { // smallest tier still covering width x height pixels
+		int tier = 0;
+		while ((entry.Width >> (tier + 1)) >= width and (entry.Height >> (tier + 1)) >= height and (entry.Width >> (tier + 1)) >= ImageLoader::MinTierSize and (entry.Height >> (tier + 1)) >= ImageLoader::MinTierSize) tier++;
+		return tier;
+	}
+
+	inline void reload(const std::string& name, float width, float height) { // decodes an evicted image again
+		if (!hasRenderer() or loadedImages.count(name)) return; // without a texture, or one that failed, it stays loaded
+		auto it = entries.find(name);
+		if (it == entries.end() or it->second.Path.empty() or it->second.Loading) return;
+		it->second.Loading = true;
+		Reloads++;
+		ImageLoader::decode(name, it->second.Path, true, tierFor(width, height, it->second));
+	}
+
+	inline void grow(const std::string& name, float width, float height) { // decodes a larger tier when a label outgrew its texture
+		auto it = entries.find(name);
+		if (it == entries.end() or it->second.Path.empty() or it->second.Tier == 0 or it->second.Loading) return;
+		int tier = tierFor(width, height, it->second);
+		if (tier >= it->second.Tier) return;
+		it->second.Loading = true;
+		Upgrades++;
+		ImageLoader::decode(name, it->second.Path, true, tier);
 	}
+}
 
-	ImagesLoadingMtx.unlock();
+inline std::unordered_map<std::string, Image> pendingImages; // decoded, waiting for an upload
+inline void loadImage(const std::string& name, const std::string& path) {
+	ImageLoader::decode(name, path, false);
 }
 
+inline void unloadImage(const std::string& name);
+
 inline std::pair<Image, Texture> getImage(const std::string& name) {
 	if (name == "") { return {}; }
 
-	ImagesLoadingMtx.lock();
 	auto it = loadedImages.find(name);
 	if (it != loadedImages.end()) {
-		ImagesLoadingMtx.unlock();
+		ImageCache::Hits++;
 		return it->second;
 	}
+	ImageCache::Misses++;
 
 	auto it1 = pendingImages.find(name);
 	if (it1 != pendingImages.end()) {
-		ImagesLoadingMtx.unlock();
 		return { it1->second, Texture{} };
 	}
-	ImagesLoadingMtx.unlock();
+
+	auto entry = ImageCache::entries.find(name);
+	if (entry != ImageCache::entries.end() and !entry->second.Path.empty()) return {}; // evicted
+
+	{
+		std::lock_guard<std::mutex> lock(ImageLoader::requestsMtx);
+		if (ImageLoader::requested.find(name) != ImageLoader::requested.end()) return {}; // still decoded
+	}
 
 	std::cout << "Image " << name << " was not found" << std::endl;
 	return {};
@@ -370,7 +1110,7 @@ inline void loadNewShader(const std::string& name, const std::string& vs, const
 		return;
 	}
 
-	Shaders.emplace(name, LoadShader(vs.c_str(), fs.c_str()));
+	Shaders.emplace(name, hasRenderer() ? LoadShader(vs.c_str(), fs.c_str()) : Shader{});
 }
 
 inline Shader getShader(const std::string& name) {
@@ -382,7 +1122,19 @@ inline Shader getShader(const std::string& name) {
 	return it->second;
 }
 
+inline Texture uploadTexture(const Image& image, bool mipmaps = true) { // empty texture when there is nothing to upload to
+	if (!hasRenderer() or !image.data) return Texture{};
+
+	Texture tex = LoadTextureFromImage(image);
+	if (mipmaps) {
+		GenTextureMipmaps(&tex);
+		SetTextureFilter(tex, TEXTURE_FILTER_TRILINEAR);
+	}
+	return tex;
+}
+
 inline Vector2 GetMouseScreenPosition() {
+	if (headless()) return GetMousePosition(); // headless window is at 0, 0
 	return { GetMouseScreenPositionX(), GetMouseScreenPositionY() };
 }
 
@@ -409,6 +1161,24 @@ inline void addFontToQueqe(const char* name, std::string path, int size) {
 inline void createFont(const char* name, std::string path, int size) {
 	static int codepointsCount = 0;
 	static int* codepoints = LoadCodepoints(" !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~ЁАБВГДЕЖЗИЙКЛМНОПРСТУФХЦЧШЩЪЫЬЭЮЯёабвгдежзийклмнопрстуфхцчшщъыьэюя", &codepointsCount);
+	if (!hasRenderer()) { // glyph metrics are enough to measure and lay out text, atlas stays on the CPU
+		int dataSize = 0;
+		unsigned char* data = LoadFileData(path.c_str(), &dataSize);
+		if (!data) return;
+
+		Font ft{};
+		ft.baseSize = size;
+		ft.glyphCount = codepointsCount;
+		ft.glyphPadding = 4;
+		ft.glyphs = LoadFontData(data, dataSize, size, codepoints, codepointsCount, FONT_DEFAULT);
+		UnloadFileData(data);
+		if (!ft.glyphs) return;
+
+		Image atlas = GenImageFontAtlas(ft.glyphs, &ft.recs, codepointsCount, size, ft.glyphPadding, 0);
+		UnloadImage(atlas);
+		Fonts.emplace(name, ft);
+		return;
+	}
 	Font ft = LoadFontEx(path.c_str(), size, codepoints, codepointsCount);
 	if (ft.texture.id) {
 		GenTextureMipmaps(&ft.texture);
@@ -419,20 +1189,41 @@ inline void createFont(const char* name, std::string path, int size) {
 	}
 }
 
+struct SUI_TextSource { // holds the edits of a SUI_Text until it is read
+	virtual size_t size() const = 0;
+	virtual char at(size_t index) const = 0;
+	virtual void copyTo(char* out) const = 0;
+};
+
 class SUI_Text {
-	std::string text;
+	mutable std::string text;
+	mutable const SUI_TextSource* source = nullptr; // text is built from it on the next read, see edited
 	bool changed = false;
+	unsigned long long revision = 0; // counts changes, unlike changed it is never reset
+
+	const std::string& read() const {
+		if (source) {
+			text.resize(source->size());
+			source->copyTo(text.data());
+			source = nullptr;
+		}
+		return text;
+	}
 public:
 	bool isChanged() const {
 		return changed;
 	}
 
+	unsigned long long Revision() const {
+		return revision;
+	}
+
 	const std::string& operator!() const {
-		return text;
+		return read();
 	}
 
 	size_t size() const {
-		return text.size();
+		return source ? source->size() : text.size();
 	}
 
 	void restate() {
@@ -440,28 +1231,30 @@ public:
 	}
 
 	bool empty() const {
-		return text.empty();
+		return size() == 0;
 	}
 
 	const char* c_str() const {
-		return text.c_str();
+		return read().c_str();
 	}
 
 	std::string substr(size_t from, size_t count = ((size_t)0 - 1)) const {
-		return text.substr(from, count);
+		return read().substr(from, count);
 	}
 
 	char operator[](size_t other) const {
-		return text[other];
+		return source ? source->at(other) : text[other];
 	}
 
 	const SUI_Text& operator=(const std::string& other) {
-		if (text.size() != other.size()) {
+		if (size() != other.size()) {
 			changed = true;
 		} else {
-			changed = text != other;
+			changed = read() != other;
 		}
 
+		revision += changed;
+		source = nullptr;
 		text = other;
 		return other;
 	}
@@ -469,73 +1262,88 @@ public:
 	const SUI_Text& operator=(const char* other) {
 		std::string st = other;
 
-		if (text.size() != st.size()) {
+		if (size() != st.size()) {
 			changed = true;
 		} else {
-			changed = text != st;
+			changed = read() != st;
 		}
 
+		revision += changed;
+		source = nullptr;
 		text = st;
 		return other;
 	}
 
 	const SUI_Text& operator=(const SUI_Text& other) {
-		if (text.size() != other.size()) {
+		if (size() != other.size()) {
 			changed = true;
 		} else {
-			changed = text != !other;
+			changed = read() != !other;
 		}
 
+		revision += changed;
 		text = !other;
+		source = nullptr;
 		return other;
 	}
 
+	void edited(const SUI_TextSource* from) { // the text is now what from holds, read from it only when needed
+		source = from;
+		changed = true;
+		revision++;
+	}
+
 	void operator+=(const std::string& other) {
+		read();
 		text += other;
 
 		if (other.size()) {
 			changed = true;
+			revision++;
 		}
 	}
 
 	bool operator==(const std::string& other) {
-		if (text.size() != other.size()) {
+		if (size() != other.size()) {
 			return false;
 		} else {
-			return text == other;
+			return read() == other;
 		}
 	}
 
 	bool operator==(const char* other) {
-		return !strcmp(text.c_str(), other);
+		if (other[0] == '\0') return empty();
+		return !strcmp(read().c_str(), other);
 	}
 
 	bool operator!=(const char* other) {
-		return strcmp(text.c_str(), other);
+		if (other[0] == '\0') return not empty();
+		return strcmp(read().c_str(), other);
 	}
 
 	bool operator!=(const std::string& other) {
-		if (text.size() == other.size()) {
-			return text != other;
+		if (size() == other.size()) {
+			return read() != other;
 		} else {
 			return true;
 		}
 	}
 
 	bool operator==(const SUI_Text& other) {
-		if (text.size() != other.size()) {
+		if (size() != other.size()) {
 			return false;
 		} else {
-			return text == !other;
+			return read() == !other;
 		}
 	}
 
 	operator std::string() {
-		return text;
+		return read();
 	}
 
 	SUI_Text(const SUI_Text& other) {
 		text = !other;
+		revision = other.revision;
 		changed = true;
 	}
 
@@ -870,6 +1678,13 @@ enum class TextAnchorEnum {
 	CENTER = 8,
 };
 
+enum class TextRenderMode {
+	GLYPHS = 0, // quads straight from the font atlas, labels with the same font share one batch
+	TEXTURE = 1, // text drawn once into an own render texture
+};
+
+inline TextRenderMode defaultTextRenderMode = TextRenderMode::GLYPHS;
+
 inline SpecialVector2 getTextOffset(TextAnchorEnum anchor) {
 	float offsetX{};
 	float offsetY{};
@@ -889,58 +1704,767 @@ inline SpecialVector2 getTextOffset(TextAnchorEnum anchor) {
 	return { offsetX, offsetY };
 }
 
-inline Vector3 getTextCFrame(const char* text, Font font, Rectangle rec, TextAnchorEnum anchor, int maxTextSize, int Spacing) {
-	if (maxTextSize < 0 or maxTextSize > rec.height) maxTextSize = rec.height;
+struct TextMetrics { // MeasureTextEx at any size from one walk over the text, width is linear in the size plus the spacing term
+	float Width = 0; // widest line in font units
+	int Chars = 0; // most codepoints on one line
+	int Lines = 0;
+	int BaseSize = 1;
 
-	int endX{};
-	int endY{};
-	float endSize = 1;
-	float sizeMax = maxTextSize;
-	SpecialVector2 textSize{};
+	Vector2 At(float fontSize, float spacing) const {
+		if (!Chars) return { 0, 0 };
+		return { Width * (fontSize / BaseSize) + (float)((Chars - 1) * spacing), Lines * fontSize + (Lines - 1) * 2.0f }; // raylib text line spacing
+	}
+};
 
-	while (endSize < sizeMax) {
-		float middle = (endSize + sizeMax + 1) / 2;
-		textSize = MeasureTextEx(font, text, middle, Spacing);
-		if (textSize.x <= rec.width and textSize.y <= rec.height) endSize = middle;
-		else sizeMax = middle - 1;
+inline TextMetrics measureText(const Font& font, const char* text) {
+	TextMetrics m;
+	if (!text or text[0] == '\0' or !font.glyphs or font.baseSize <= 0) return m;
+
+	m.BaseSize = font.baseSize;
+	m.Lines = 1;
+	float width = 0;
+	int chars = 0;
+	for (int i = 0; text[i] != '\0';) {
+		int bytes = 0;
+		int codepoint = GetCodepointNext(&text[i], &bytes);
+		int index = GetGlyphIndex(font, codepoint);
+		i += bytes;
+
+		if (codepoint == '\n') {
+			m.Width = std::max(m.Width, width);
+			width = 0;
+			chars = 0;
+			m.Lines++;
+		} else {
+			width += font.glyphs[index].advanceX > 0 ? font.glyphs[index].advanceX : font.recs[index].width + font.glyphs[index].offsetX;
+			m.Chars = std::max(m.Chars, ++chars);
+		}
 	}
+	m.Width = std::max(m.Width, width);
+	return m;
+}
 
-	if (endSize > maxTextSize) endSize = maxTextSize;
-	SpecialVector2 ofst = getTextOffset(anchor);
-	float offsetX = ofst.x;
-	float offsetY = ofst.y;
+namespace MetricsCache { // strings measured once for every text object, the least recently used are dropped
+	inline size_t MaxBytes = 1 << 20; // text and bookkeeping kept, a long TextBox with line breaks adds its whole string for every edit
+	inline unsigned long long Hits = 0;
+	inline unsigned long long Misses = 0;
 
-	endX = offsetX * (rec.width - textSize.x); if (endX < 0) endX = 0;
-	endY = offsetY * (rec.height - textSize.y);  if (endX < 0) endX = 0;
+	struct Entry {
+		const void* Font;
+		std::string Text;
+		TextMetrics Metrics;
+	};
 
-	return { (float)endX, (float)endY, (float)endSize };
-}
+	struct Key {
+		const void* Font;
+		std::string_view Text; // points into the entry
+		bool operator==(const Key&) const = default;
+	};
 
-class TextLabel;
-class Instance;
-class Object2D;
-class TextBox;
-class ImageLabel;
-class ScrollFrame;
-class TextureLabel;
-class LineEx;
+	struct KeyHash {
+		size_t operator()(const Key& k) const {
+			return std::hash<std::string_view>{}(k.Text) ^ ((size_t)(uintptr_t)k.Font * 0x9e3779b97f4a7c15ull);
+		}
+	};
 
-inline TextBox* FocusedTextBox = nullptr;
-inline Object2D* PreviousHigherObject = nullptr;
-inline Object2D* higherObject = nullptr;
+	inline std::list<Entry> entries; // most recently used first
+	inline std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+	inline size_t bytes = 0;
 
-inline std::unordered_map<long, Instance*> deletedObjectsByID;
-inline std::unordered_map<Instance*, long> deletedObjectsByPtr;
+	inline size_t cost(const Entry& e) { // list node, index node and the string
+		return e.Text.capacity() + sizeof(Entry) + sizeof(Key) + 4 * sizeof(void*);
+	}
 
-enum InstanceType {
-	INSTANCE = 0,
-	OBJECT2D,
-	TEXTLABEL,
-	TEXTBOX,
-	IMAGELABEL,
-	SCROLLFRAME,
-	TEXTURELABEL,
-	LINEEX,
+	inline const TextMetrics& Get(const Font& font, std::string_view text) { // valid until the next Get
+		auto it = index.find({ font.glyphs, text });
+		if (it != index.end()) {
+			Hits++;
+			if (Profiler::inFrame) Profiler::current.MetricsHits++;
+			entries.splice(entries.begin(), entries, it->second);
+			return it->second->Metrics;
+		}
+
+		Misses++;
+		if (Profiler::inFrame) Profiler::current.MetricsMisses++;
+		entries.push_front({ font.glyphs, std::string(text), {} });
+		Entry& e = entries.front();
+		e.Metrics = measureText(font, e.Text.c_str());
+		index.emplace(Key{ e.Font, e.Text }, entries.begin());
+		bytes += cost(e);
+
+		while (bytes > MaxBytes and entries.size() > 1) { // the newest entry stays until the next Get
+			bytes -= cost(entries.back());
+			index.erase({ entries.back().Font, entries.back().Text });
+			entries.pop_back();
+		}
+		return e.Metrics;
+	}
+
+	inline void Clear() {
+		index.clear();
+		entries.clear();
+		bytes = 0;
+	}
+}
+
+// Biggest size up to maxTextSize (rec height when negative) at which the text fits into rec, solved from the metrics
+inline Vector3 getTextCFrame(const TextMetrics& metrics, Rectangle rec, TextAnchorEnum anchor, int maxTextSize, int Spacing) {
+	if (maxTextSize < 0 or maxTextSize > rec.height) maxTextSize = rec.height;
+
+	float endSize = maxTextSize;
+	if (metrics.Chars) {
+		if (metrics.Width > 0) endSize = std::min(endSize, (rec.width - (metrics.Chars - 1) * Spacing) * metrics.BaseSize / metrics.Width);
+		endSize = std::min(endSize, (rec.height - (metrics.Lines - 1) * 2.0f) / metrics.Lines);
+	}
+	endSize = std::max(endSize, 1.0f);
+	if (endSize > maxTextSize) endSize = maxTextSize;
+
+	SpecialVector2 textSize = metrics.At(endSize, Spacing);
+	SpecialVector2 ofst = getTextOffset(anchor);
+
+	int endX = ofst.x * (rec.width - textSize.x); if (endX < 0) endX = 0;
+	int endY = ofst.y * (rec.height - textSize.y);
+
+	return { (float)endX, (float)endY, endSize };
+}
+
+inline Vector3 getTextCFrame(const char* text, Font font, Rectangle rec, TextAnchorEnum anchor, int maxTextSize, int Spacing) {
+	return getTextCFrame(measureText(font, text), rec, anchor, maxTextSize, Spacing);
+}
+
+struct GlyphLayout { // source and destination rectangle of every visible glyph, relative to the text origin
+	std::vector<Rectangle> Quads;
+	Rectangle Bounds{};
+	unsigned long long Hash = 0;
+};
+
+// Same placement as DrawTextEx, kept so the text can be drawn again without measuring
+inline void layoutGlyphs(GlyphLayout& layout, const Font& font, const char* text, float fontSize, float spacing) {
+	layout.Quads.clear();
+	layout.Bounds = {};
+	if (!font.recs or !font.glyphs or font.baseSize <= 0) return;
+
+	float scale = fontSize / font.baseSize;
+	float padding = font.glyphPadding;
+	float offsetX = 0, offsetY = 0;
+	float x1 = 1e9f, y1 = 1e9f, x2 = -1e9f, y2 = -1e9f;
+
+	for (int i = 0; text[i] != '\0';) {
+		int bytes = 0;
+		int codepoint = GetCodepointNext(&text[i], &bytes);
+		int index = GetGlyphIndex(font, codepoint);
+		i += bytes;
+
+		if (codepoint == '\n') {
+			offsetY += fontSize + 2; // raylib text line spacing
+			offsetX = 0;
+			continue;
+		}
+
+		const Rectangle& rec = font.recs[index];
+		if (codepoint != ' ' and codepoint != '\t') {
+			Rectangle source = { rec.x - padding, rec.y - padding, rec.width + 2 * padding, rec.height + 2 * padding };
+			Rectangle dest = { offsetX + (font.glyphs[index].offsetX - padding) * scale, offsetY + (font.glyphs[index].offsetY - padding) * scale,
+				source.width * scale, source.height * scale };
+			layout.Quads.push_back(source);
+			layout.Quads.push_back(dest);
+
+			x1 = std::min(x1, dest.x); y1 = std::min(y1, dest.y);
+			x2 = std::max(x2, dest.x + dest.width); y2 = std::max(y2, dest.y + dest.height);
+		}
+
+		offsetX += (font.glyphs[index].advanceX ? font.glyphs[index].advanceX : rec.width) * scale + spacing;
+	}
+
+	if (!layout.Quads.empty()) layout.Bounds = { x1, y1, x2 - x1, y2 - y1 };
+
+	unsigned long long h = 1469598103934665603ull; // FNV-1a over the quads, compared by damage tracking
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(layout.Quads.data());
+	for (size_t i = 0; i < layout.Quads.size() * sizeof(Rectangle); i++) {
+		h = (h ^ bytes[i]) * 1099511628211ull;
+	}
+	layout.Hash = h ^ font.texture.id;
+}
+
+namespace DrawList { // draw calls recorded during the tree walk and submitted sorted by texture at the end of the frame
+	enum CommandType : unsigned char {
+		RECTANGLE_ROUNDED = 0,
+		RECTANGLE_ROUNDED_LINES,
+		TEXTURE_PRO,
+		TEXTURE_PRO_ROUNDED, // texture cut by TextureRoundness shader
+		LINE,
+		SCISSOR_BEGIN,
+		SCISSOR_END,
+		GLYPHS // quads of a GlyphLayout taken from glyphs, Segments of them starting at First
+	};
+
+	struct Command {
+		CommandType Type = RECTANGLE_ROUNDED;
+		Rectangle Rec{};
+		Rectangle Source{};
+		Vector2 Origin{};
+		Vector2 From{};
+		Vector2 To{};
+		float Rotation = 0;
+		float Roundness = 0;
+		float Thickness = 0;
+		int Segments = 0;
+		int First = 0;
+		unsigned long long Content = 0;
+		Color Tint{};
+		Texture2D Tex{};
+		const void* Owner = nullptr;
+	};
+
+	struct Batch {
+		unsigned long long Key;
+		Rectangle Bounds;
+	};
+
+	struct OwnerState {
+		unsigned long long Hash;
+		Rectangle Bounds;
+	};
+
+	inline bool Enabled = true; // false sends every call to raylib immediately
+	inline int BatchLookback = 32; // how many batches back a command can be moved to join one with the same texture
+	inline int BatchBufferElements = 65536; // quads per vertex buffer of the render batch (raylib default is 8192)
+	inline bool DamageTracking = true; // frame is kept in a render texture and only changed regions are drawn again
+	inline int MaxDamageRects = 8; // more dirty regions than this are merged into one
+	inline int MaxDamageInputs = 256; // more regions collected in a frame skip merging and become one
+	inline float FullRedrawArea = 0.6f; // part of the window after which dirty regions are replaced by a full redraw
+	inline Color Background = { 255,255,255,255 };
+
+	inline std::vector<Command> commands;
+	inline std::vector<Batch> batches;
+	inline std::vector<int> batchOf;
+	inline std::vector<int> order;
+	inline std::vector<int> sorted;
+	inline bool recording = false;
+	inline bool batchLoaded = false;
+	inline rlRenderBatch renderBatch{};
+
+	inline const void* owner = nullptr;
+	inline std::unordered_map<const void*, OwnerState> owners;
+	inline std::unordered_map<const void*, OwnerState> previousOwners;
+	inline std::unordered_set<unsigned int> changedTextures;
+	inline std::vector<Rectangle> damage;
+	inline std::vector<Rectangle> mergedDamage;
+	inline unsigned long long flushCount = 0;
+	inline RenderTexture2D target{};
+	inline bool fullRedraw = true;
+	inline bool clipToDamage = false;
+	inline Rectangle damageClip{};
+	inline std::vector<Command> Frame; // commands of the last frame without a renderer
+	inline std::vector<Rectangle> glyphs; // source and destination of every recorded glyph quad
+	inline std::vector<Rectangle> FrameGlyphs;
+
+	struct OwnerScope { // commands recorded inside belong to the object, its changes are compared between frames
+		const void* previous;
+		OwnerScope(const void* o) : previous(owner) { owner = o; }
+		~OwnerScope() { owner = previous; }
+	};
+
+	inline bool Recording() {
+		return recording;
+	}
+
+	inline void Invalidate() { // next frame is drawn completely
+		fullRedraw = true;
+	}
+
+	inline Rectangle intersect(const Rectangle& a, const Rectangle& b) {
+		float x1 = std::max(a.x, b.x), y1 = std::max(a.y, b.y);
+		float x2 = std::min(a.x + a.width, b.x + b.width), y2 = std::min(a.y + a.height, b.y + b.height);
+		return { x1, y1, std::max(0.0f, x2 - x1), std::max(0.0f, y2 - y1) };
+	}
+
+	inline Rectangle unite(const Rectangle& a, const Rectangle& b) {
+		float x1 = std::min(a.x, b.x), y1 = std::min(a.y, b.y);
+		float x2 = std::max(a.x + a.width, b.x + b.width), y2 = std::max(a.y + a.height, b.y + b.height);
+		return { x1, y1, x2 - x1, y2 - y1 };
+	}
+
+	inline void drawGlyphs(Texture2D tex, const Rectangle* quads, int count, Vector2 offset, Color tint) {
+		for (int i = 0; i < count; i++) {
+			const Rectangle& dest = quads[i * 2 + 1];
+			DrawTexturePro(tex, quads[i * 2], { dest.x + offset.x, dest.y + offset.y, dest.width, dest.height }, { 0,0 }, 0, tint);
+		}
+	}
+
+	inline void submit(const Command& c) {
+		switch (c.Type) {
+			case RECTANGLE_ROUNDED: {
+				DrawRectangleRounded(c.Rec, c.Roundness, c.Segments, c.Tint);
+				break;
+			} case RECTANGLE_ROUNDED_LINES: {
+				DrawRectangleRoundedLinesEx(c.Rec, c.Roundness, c.Segments, c.Thickness, c.Tint);
+				break;
+			} case TEXTURE_PRO: {
+				DrawTexturePro(c.Tex, c.Source, c.Rec, c.Origin, c.Rotation, c.Tint);
+				break;
+			} case TEXTURE_PRO_ROUNDED: {
+				static Shader shader = getShader("TextureRoundness");
+				static float lastRoundness = 0;
+				static Rectangle lastObjectData = { 0,0,0,0 };
+				static Rectangle lastImageData = { 0,0,0,0 };
+
+				if (c.Roundness != lastRoundness) {
+					lastRoundness = c.Roundness;
+					SetShaderValue(shader, GetShaderLocation(shader, "roundness"), &c.Roundness, SHADER_UNIFORM_FLOAT);
+				}
+
+				if (c.Rec.width != lastObjectData.width or c.Rec.height != lastObjectData.height) {
+					lastObjectData = c.Rec;
+					SetShaderValue(shader, GetShaderLocation(shader, "objectData"), &c.Rec, SHADER_UNIFORM_VEC4);
+				}
+				if (c.Source.x != lastImageData.x or c.Source.y != lastImageData.y or
+					c.Source.width != lastImageData.width or c.Source.height != lastImageData.height) {
+					lastImageData = c.Source;
+					SetShaderValue(shader, GetShaderLocation(shader, "imageData"), &c.Source, SHADER_UNIFORM_VEC4);
+				}
+
+				BeginShaderMode(shader);
+				DrawTexturePro(c.Tex, c.Source, c.Rec, c.Origin, c.Rotation, c.Tint);
+				EndShaderMode();
+				break;
+			} case LINE: {
+				DrawLineEx(c.From, c.To, c.Thickness, c.Tint);
+				break;
+			} case SCISSOR_BEGIN: {
+				Rectangle r = clipToDamage ? intersect(c.Rec, damageClip) : c.Rec;
+				BeginScissorMode((int)r.x, (int)r.y, (int)r.width, (int)r.height);
+				break;
+			} case SCISSOR_END: {
+				if (clipToDamage) BeginScissorMode((int)damageClip.x, (int)damageClip.y, (int)damageClip.width, (int)damageClip.height);
+				else EndScissorMode();
+				break;
+			} case GLYPHS: {
+				drawGlyphs(c.Tex, &glyphs[c.First * 2], c.Segments, { 0,0 }, c.Tint);
+				break;
+			}
+		}
+	}
+
+	inline void record(const Command& c) {
+		if (recording) {
+			commands.push_back(c);
+			commands.back().Owner = owner;
+		} else {
+			submit(c);
+		}
+	}
+
+	inline void RectangleRounded(Rectangle rec, float roundness, int segments, Color color) {
+		Command c;
+		c.Type = RECTANGLE_ROUNDED; c.Rec = rec; c.Roundness = roundness; c.Segments = segments; c.Tint = color;
+		record(c);
+	}
+
+	inline void RectangleRoundedLines(Rectangle rec, float roundness, int segments, float thickness, Color color) {
+		Command c;
+		c.Type = RECTANGLE_ROUNDED_LINES; c.Rec = rec; c.Roundness = roundness; c.Segments = segments; c.Thickness = thickness; c.Tint = color;
+		record(c);
+	}
+
+	// content tells damage tracking that a region of a shared texture was redrawn without TextureChanged for all of it
+	inline void TexturePro(Texture2D tex, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint, unsigned long long content = 0) {
+		Command c;
+		c.Type = TEXTURE_PRO; c.Tex = tex; c.Source = source; c.Rec = dest; c.Origin = origin; c.Rotation = rotation; c.Tint = tint; c.Content = content;
+		record(c);
+	}
+
+	inline void TextureProRounded(Texture2D tex, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint, float roundness) {
+		Command c;
+		c.Type = TEXTURE_PRO_ROUNDED; c.Tex = tex; c.Source = source; c.Rec = dest; c.Origin = origin; c.Rotation = rotation; c.Tint = tint; c.Roundness = roundness;
+		record(c);
+	}
+
+	inline void Line(Vector2 from, Vector2 to, float thickness, Color color) {
+		Command c;
+		c.Type = LINE; c.From = from; c.To = to; c.Thickness = thickness; c.Tint = color;
+		record(c);
+	}
+
+	inline void Glyphs(Texture2D tex, const GlyphLayout& layout, Vector2 position, Color tint) { // one command for the whole run
+		int count = (int)layout.Quads.size() / 2;
+		if (!count) return;
+		if (!recording) {
+			drawGlyphs(tex, layout.Quads.data(), count, position, tint);
+			return;
+		}
+
+		Command c;
+		c.Type = GLYPHS; c.Tex = tex; c.Tint = tint; c.Content = layout.Hash;
+		c.Rec = { layout.Bounds.x + position.x, layout.Bounds.y + position.y, layout.Bounds.width, layout.Bounds.height };
+		c.First = (int)glyphs.size() / 2; c.Segments = count;
+		for (int i = 0; i < count; i++) {
+			const Rectangle& dest = layout.Quads[i * 2 + 1];
+			glyphs.push_back(layout.Quads[i * 2]);
+			glyphs.push_back({ dest.x + position.x, dest.y + position.y, dest.width, dest.height });
+		}
+		record(c);
+	}
+
+	inline void Scissor(int x, int y, int w, int h) {
+		Command c;
+		c.Type = SCISSOR_BEGIN; c.Rec = { (float)x, (float)y, (float)w, (float)h };
+		record(c);
+	}
+
+	inline void EndScissor() {
+		Command c;
+		c.Type = SCISSOR_END;
+		record(c);
+	}
+
+	inline void ReleaseTexture(unsigned int id) { // call before unloading a texture which could be recorded in this frame
+		if (!id) return;
+		TextureChanged(id);
+		if (!recording) return;
+		for (Command& c : commands) { // the id can be handed out again right away, so only already recorded draws are dropped
+			if ((c.Type == TEXTURE_PRO or c.Type == TEXTURE_PRO_ROUNDED or c.Type == GLYPHS) and c.Tex.id == id) c.Tex.id = 0;
+		}
+	}
+
+	inline void TextureChanged(unsigned int id) { // content of a texture was redrawn, places where it is shown get redrawn too
+		if (DamageTracking and id) changedTextures.insert(id);
+	}
+
+	inline Rectangle boundsOf(const Command& c) {
+		switch (c.Type) {
+			case RECTANGLE_ROUNDED: {
+				return c.Rec;
+			} case RECTANGLE_ROUNDED_LINES: {
+				return { c.Rec.x - c.Thickness, c.Rec.y - c.Thickness, c.Rec.width + c.Thickness * 2, c.Rec.height + c.Thickness * 2 };
+			} case TEXTURE_PRO: case TEXTURE_PRO_ROUNDED: {
+				if (c.Rotation != 0) break;
+				return { c.Rec.x - c.Origin.x, c.Rec.y - c.Origin.y, std::fabs(c.Rec.width), std::fabs(c.Rec.height) };
+			} case LINE: {
+				float x = std::min(c.From.x, c.To.x) - c.Thickness;
+				float y = std::min(c.From.y, c.To.y) - c.Thickness;
+				return { x, y, std::max(c.From.x, c.To.x) + c.Thickness - x, std::max(c.From.y, c.To.y) + c.Thickness - y };
+			} case GLYPHS: {
+				return c.Rec;
+			}
+			default: break;
+		}
+
+		return { -1e9f, -1e9f, 2e9f, 2e9f };
+	}
+
+	inline unsigned long long keyOf(const Command& c, size_t index) {
+		switch (c.Type) {
+			case RECTANGLE_ROUNDED: case RECTANGLE_ROUNDED_LINES: return 0;
+			case LINE: return 1;
+			case TEXTURE_PRO: case GLYPHS: return (2ull << 32) | c.Tex.id; // glyphs join other draws of the font atlas
+			default: return (3ull << 32) | index; // shader draws have own uniforms and never merge
+		}
+	}
+
+	inline bool overlaps(const Rectangle& a, const Rectangle& b) {
+		return a.x < b.x + b.width and b.x < a.x + a.width and a.y < b.y + b.height and b.y < a.y + a.height;
+	}
+
+	inline bool isReleased(const Command& c) {
+		return (c.Type == TEXTURE_PRO or c.Type == TEXTURE_PRO_ROUNDED or c.Type == GLYPHS) and c.Tex.id == 0;
+	}
+
+	inline unsigned long long mix(unsigned long long h, unsigned long long v) {
+		h ^= v + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+		return h;
+	}
+
+	inline unsigned long long mixFloat(unsigned long long h, float f) {
+		unsigned int bits;
+		std::memcpy(&bits, &f, sizeof(bits));
+		return mix(h, bits);
+	}
+
+	inline unsigned long long hashOf(const Command& c) {
+		unsigned long long h = c.Type;
+		for (float f : { c.Rec.x, c.Rec.y, c.Rec.width, c.Rec.height, c.Source.x, c.Source.y, c.Source.width, c.Source.height,
+			c.Origin.x, c.Origin.y, c.From.x, c.From.y, c.To.x, c.To.y, c.Rotation, c.Roundness, c.Thickness }) {
+			h = mixFloat(h, f);
+		}
+		h = mix(h, c.Segments);
+		h = mix(h, c.Content);
+		h = mix(h, ((unsigned int)c.Tint.r << 24) | ((unsigned int)c.Tint.g << 16) | ((unsigned int)c.Tint.b << 8) | c.Tint.a);
+		h = mix(h, c.Tex.id);
+
+		if (c.Tex.id and changedTextures.count(c.Tex.id)) {
+			h = mix(h, flushCount);
+		}
+
+		return h;
+	}
+
+	inline void addDamage(Rectangle r) {
+		r = intersect(r, { 0, 0, (float)winWidth, (float)winHeight });
+		if (r.width <= 0 or r.height <= 0) return;
+
+		// pixel aligned with a margin for antialiased edges
+		float x1 = std::floor(r.x) - 2, y1 = std::floor(r.y) - 2;
+		float x2 = std::ceil(r.x + r.width) + 2, y2 = std::ceil(r.y + r.height) + 2;
+		damage.push_back({ x1, y1, x2 - x1, y2 - y1 });
+	}
+
+	// Every object's commands are hashed, an object which was added, removed or drew anything differently
+	// marks its old and new bounds dirty. The previous owner is part of the hash so reordering is noticed too.
+	inline void collectDamage() {
+		const void* previous = nullptr;
+		for (const Command& c : commands) {
+			auto [it, inserted] = owners.try_emplace(c.Owner, OwnerState{ 0, { 0,0,0,0 } });
+			OwnerState& st = it->second;
+
+			if (inserted) {
+				st.Hash = mix(0, (unsigned long long)(uintptr_t)previous);
+				st.Bounds = { 0,0,0,0 };
+			}
+			st.Hash = mix(st.Hash, hashOf(c));
+
+			if (c.Type != SCISSOR_BEGIN and c.Type != SCISSOR_END and !isReleased(c)) {
+				Rectangle b = boundsOf(c);
+				st.Bounds = (st.Bounds.width <= 0 and st.Bounds.height <= 0) ? b : unite(st.Bounds, b);
+			}
+			previous = c.Owner;
+		}
+
+		for (auto& [key, st] : owners) {
+			auto it = previousOwners.find(key);
+			if (it == previousOwners.end()) {
+				addDamage(st.Bounds);
+			} else {
+				const OwnerState& old = it->second;
+				if (old.Hash != st.Hash or old.Bounds.x != st.Bounds.x or old.Bounds.y != st.Bounds.y
+					or old.Bounds.width != st.Bounds.width or old.Bounds.height != st.Bounds.height) {
+					addDamage(old.Bounds);
+					addDamage(st.Bounds);
+				}
+				previousOwners.erase(it);
+			}
+		}
+
+		for (auto& [key, old] : previousOwners) {
+			addDamage(old.Bounds);
+		}
+
+		previousOwners.clear();
+		std::swap(owners, previousOwners);
+
+		// overlapping regions are merged in one sweep from left to right, too many of them become one bounding region.
+		// A region grown by a later merge can still overlap one checked before, those parts are just drawn twice.
+		if (damage.size() <= (size_t)MaxDamageInputs) {
+			std::sort(damage.begin(), damage.end(), [](const Rectangle& a, const Rectangle& b) { return a.x < b.x; });
+			mergedDamage.clear();
+			size_t closed = 0; // mergedDamage[0, closed) ends left of every region still to come
+			for (const Rectangle& r : damage) {
+				Rectangle u = r;
+				for (size_t j = closed; j < mergedDamage.size();) {
+					if (mergedDamage[j].x + mergedDamage[j].width < r.x) {
+						std::swap(mergedDamage[j++], mergedDamage[closed++]);
+					} else if (overlaps(mergedDamage[j], u)) {
+						u = unite(u, mergedDamage[j]);
+						mergedDamage[j] = mergedDamage.back();
+						mergedDamage.pop_back();
+					} else {
+						j++;
+					}
+				}
+				mergedDamage.push_back(u);
+			}
+			std::swap(damage, mergedDamage);
+		}
+
+		if (damage.size() > (size_t)MaxDamageRects) {
+			Rectangle all = damage[0];
+			for (const Rectangle& r : damage) all = unite(all, r);
+			damage.assign(1, all);
+		}
+
+		float area = 0;
+		for (const Rectangle& r : damage) area += r.width * r.height;
+		if (area > FullRedrawArea * winWidth * winHeight) fullRedraw = true;
+	}
+
+	inline void Begin() {
+		recording = Enabled or !hasRenderer();
+		commands.clear();
+		glyphs.clear();
+	}
+
+	inline void Flush() {
+		recording = false;
+
+		if (!hasRenderer()) { // nothing to draw into, the frame is kept for SUI_CaptureFrame and damage is still collected
+			damage.clear();
+			if (DamageTracking) {
+				flushCount++;
+				collectDamage();
+				changedTextures.clear();
+			}
+			std::swap(Frame, commands);
+			std::swap(FrameGlyphs, glyphs);
+			return;
+		}
+
+		damage.clear();
+		if (DamageTracking) {
+			if (target.id == 0 or target.texture.width != winWidth or target.texture.height != winHeight) {
+				if (target.id) UnloadRenderTexture(target);
+				target = LoadRenderTexture(winWidth, winHeight);
+				fullRedraw = true;
+			}
+			flushCount++;
+			collectDamage();
+			changedTextures.clear();
+		}
+
+		if (commands.empty() and !DamageTracking) return;
+
+		if (!batchLoaded) {
+			batchLoaded = true;
+			if (RAYLIB_FUNCTIONAL::rlGetVersion() >= RAYLIB_FUNCTIONAL::RL_OPENGL_33 and RAYLIB_FUNCTIONAL::rlGetVersion() <= RAYLIB_FUNCTIONAL::RL_OPENGL_43) {
+				renderBatch = rlLoadRenderBatch(1, BatchBufferElements);
+				rlSetRenderBatchActive(&renderBatch);
+			}
+		}
+
+		// Every command joins the latest batch with the same texture unless something drawn in between overlaps it,
+		// so the picture stays the same while texture switches (and batch flushes) are reduced. Scissor changes split the list.
+		batches.clear();
+		batchOf.assign(commands.size(), -1);
+		int segmentStart = 0;
+
+		for (size_t i = 0; i < commands.size(); i++) {
+			const Command& c = commands[i];
+
+			if (c.Type == SCISSOR_BEGIN or c.Type == SCISSOR_END) {
+				batchOf[i] = (int)batches.size();
+				batches.push_back({ ~0ull, {} });
+				segmentStart = (int)batches.size();
+				continue;
+			}
+
+			if (isReleased(c)) continue;
+
+			Rectangle bounds = boundsOf(c);
+			unsigned long long key = keyOf(c, i);
+			int target = -1;
+			int lowest = std::max(segmentStart, (int)batches.size() - BatchLookback);
+
+			for (int j = (int)batches.size() - 1; j >= lowest; j--) {
+				if (batches[j].Key == key) { target = j; break; }
+				if (overlaps(batches[j].Bounds, bounds)) break;
+			}
+
+			if (target == -1) {
+				target = (int)batches.size();
+				batches.push_back({ key, bounds });
+			} else {
+				Rectangle& b = batches[target].Bounds;
+				float x1 = std::min(b.x, bounds.x), y1 = std::min(b.y, bounds.y);
+				float x2 = std::max(b.x + b.width, bounds.x + bounds.width), y2 = std::max(b.y + b.height, bounds.y + bounds.height);
+				b = { x1, y1, x2 - x1, y2 - y1 };
+			}
+
+			batchOf[i] = target;
+		}
+
+		// counting sort by batch index, painter's order inside a batch is kept
+		order.assign(batches.size() + 1, 0);
+		for (int b : batchOf) {
+			if (b >= 0) order[b + 1]++;
+		}
+		for (size_t i = 1; i < order.size(); i++) {
+			order[i] += order[i - 1];
+		}
+		sorted.resize(order.back());
+		for (size_t i = 0; i < commands.size(); i++) {
+			if (batchOf[i] >= 0) sorted[order[batchOf[i]]++] = (int)i;
+		}
+
+		if (!DamageTracking) {
+			if (target.id) {
+				UnloadRenderTexture(target);
+				target = {};
+			}
+			for (int i : sorted) {
+				submit(commands[i]);
+			}
+		} else {
+			if (fullRedraw) damage.assign(1, { 0, 0, (float)winWidth, (float)winHeight });
+
+			if (!damage.empty()) {
+				rlDrawRenderBatchActive();
+				BeginTextureMode(target);
+				clipToDamage = true;
+				for (const Rectangle& r : damage) {
+					damageClip = r;
+					BeginScissorMode((int)r.x, (int)r.y, (int)r.width, (int)r.height);
+					ClearBackground(Background);
+					for (int i : sorted) {
+						const Command& c = commands[i];
+						if (c.Type == SCISSOR_BEGIN or c.Type == SCISSOR_END or overlaps(boundsOf(c), r)) submit(c);
+					}
+					EndScissorMode();
+				}
+				clipToDamage = false;
+				EndTextureMode();
+			}
+
+			// blending is off, alpha written into the target must not mix with the window background
+			rlDrawRenderBatchActive();
+			rlDisableColorBlend();
+			DrawTextureRec(target.texture, { 0, 0, (float)target.texture.width, -(float)target.texture.height }, { 0, 0 }, { 255,255,255,255 });
+			rlDrawRenderBatchActive();
+			rlEnableColorBlend();
+		}
+
+		fullRedraw = false;
+		commands.clear();
+	}
+
+	inline void Shutdown() {
+		if (target.id) {
+			UnloadRenderTexture(target);
+			target = {};
+		}
+		if (batchLoaded and renderBatch.vertexBuffer) {
+			rlSetRenderBatchActive(nullptr);
+			rlUnloadRenderBatch(renderBatch);
+			renderBatch = {};
+		}
+		batchLoaded = false;
+	}
+}
+
+class TextLabel;
+class Instance;
+class Object2D;
+void invalidateLayout(Instance*, bool sizeToo = true);
+class TextBox;
+class ImageLabel;
+class ScrollFrame;
+class TextureLabel;
+class LineEx;
+
+inline TextBox* FocusedTextBox = nullptr;
+inline Object2D* PreviousHigherObject = nullptr;
+inline Object2D* higherObject = nullptr;
+
+inline std::unordered_map<long, Instance*> deletedObjectsByID;
+inline std::unordered_map<Instance*, long> deletedObjectsByPtr;
+
+enum InstanceType {
+	INSTANCE = 0,
+	OBJECT2D,
+	TEXTLABEL,
+	TEXTBOX,
+	IMAGELABEL,
+	SCROLLFRAME,
+	TEXTURELABEL,
+	LINEEX,
 
 	STRING_VALUE,
 	INT_VALUE,
@@ -951,9 +2475,43 @@ enum InstanceType {
 	VECTOR2_VALUE,
 	COLOR_VALUE,
 
-	FOLDER
+	FOLDER,
+
+	INSTANCE_TYPE_COUNT
+};
+
+enum ClassTrait : unsigned char {
+	TRAIT_2D = 1 << 0, // Object2D inheritor
+	TRAIT_SCROLL = 1 << 1, // children are placed on a scrolled canvas and culled by sectors
+	TRAIT_ZINDEX = 1 << 2,
+	TRAIT_TEXT = 1 << 3, // has Text and TextColor
+	TRAIT_DRAWS = 1 << 4, // draws itself, counted as culled when it does not
+	TRAIT_INPUT = 1 << 5, // takes the keyboard focus
 };
 
+constexpr unsigned char classTraits(InstanceType type) {
+	constexpr unsigned char object2D = TRAIT_2D | TRAIT_ZINDEX | TRAIT_DRAWS;
+	switch (type) {
+	case OBJECT2D: case IMAGELABEL: case TEXTURELABEL: return object2D;
+	case TEXTLABEL: return object2D | TRAIT_TEXT;
+	case TEXTBOX: return object2D | TRAIT_TEXT | TRAIT_INPUT;
+	case SCROLLFRAME: return object2D | TRAIT_SCROLL;
+	case LINEEX: return TRAIT_ZINDEX | TRAIT_DRAWS;
+	default: return 0;
+	}
+}
+
+// Generated at compile time, type checks in the tree walk, hit testing and sorting are one mask test
+inline constexpr std::array<unsigned char, INSTANCE_TYPE_COUNT> ClassTraits = []() {
+	std::array<unsigned char, INSTANCE_TYPE_COUNT> table{};
+	for (int i = 0; i < INSTANCE_TYPE_COUNT; i++) table[i] = classTraits((InstanceType)i);
+	return table;
+}();
+
+inline bool HasTrait(InstanceType type, unsigned char mask) {
+	return ClassTraits[type] & mask;
+}
+
 Instance* getAncestorWhichParentIsScrollFrame(Instance* ptr);
 
 template<typename Z>
@@ -993,6 +2551,10 @@ inline void Delete(Z* ptr) {
 
 inline void updateChildren(Instance*);
 
+#if SUI_PROFILER
+inline void countCallback(Instance* obj);
+#endif
+
 struct InstanceCallback {
 	std::function<void(Instance*, Instance*)> func;
 
@@ -1011,6 +2573,9 @@ struct InstanceCallback {
 
 	void operator()(Instance* a, Instance* b = nullptr) const {
 		if (func) {
+#if SUI_PROFILER
+			countCallback(a);
+#endif
 			func(a, b);
 		}
 	}
@@ -1022,6 +2587,23 @@ class Instance {
 protected:
 	size_t lastUpdateFrame = 0;
 public:
+#if SUI_PROFILER
+	struct Cost { // what this object did in the current frame, counted while Profiler::ObjectCosts is on
+		size_t Frame = 0;
+		int Drawn = 0;
+		int TextRegens = 0;
+		int Callbacks = 0;
+		double UpdateTime = 0; // seconds, including children
+		bool Timing = false;
+	};
+	Cost cost;
+
+	Cost& frameCost() {
+		if (cost.Frame != framesSinceStart) cost = Cost{ framesSinceStart };
+		return cost;
+	}
+#endif
+
 	const long uniqueID = -1;
 	std::unordered_map<long, Instance*> childsAddedInFrame;
 	std::unordered_map<long, Instance*> childsRemovedInFrame;
@@ -1042,11 +2624,50 @@ public:
 
 	bool updateChildrenZIndex = true;
 
+	struct QueueMark { // queues the object waits in, not copied with the object
+		bool Queued = false; // in its parent's zOrderPending
+		bool Placed = false; // in the sorted part of Parent->Children, new children wait unsorted behind it
+		bool HitChanged = false; // in HitIndex::changedParents
+
+		QueueMark() = default;
+		QueueMark(const QueueMark&) {}
+		QueueMark& operator=(const QueueMark&) { return *this; }
+	};
+
+	struct ChildQueue { // children to be placed by ZIndex in next updateChildren, not copied with the object
+		std::vector<Instance*> items;
+
+		ChildQueue() = default;
+		ChildQueue(const ChildQueue&) {}
+		ChildQueue& operator=(const ChildQueue&) { items.clear(); return *this; }
+
+		void push(Instance* child) {
+			if (child->zOrderMark.Queued) return;
+			child->zOrderMark.Queued = true;
+			items.push_back(child);
+		}
+
+		void remove(Instance* child) {
+			if (!child->zOrderMark.Queued) return;
+			child->zOrderMark.Queued = false;
+			items.erase(std::remove(items.begin(), items.end(), child), items.end());
+		}
+
+		void clear() {
+			for (Instance* child : items) child->zOrderMark.Queued = false;
+			items.clear();
+		}
+	};
+	QueueMark zOrderMark;
+	ChildQueue zOrderPending;
+	long long zOrderKey = 0; // key this object is sorted by in Parent->Children
+	unsigned long long zOrderSequence = 0; // placement order among equal keys
+
 	Instance* Parent = nullptr;
 	std::vector<Instance*> Children;
 
 	std::string Name = "Instance";
-	InstanceType Class;
+	InstanceType Class = INSTANCE;
 
 	bool __ParentObject{};
 
@@ -1055,12 +2676,18 @@ public:
 		if (p) { 
 			p->Children.push_back(this); 
 			p->childsAddedInFrame.insert({ p->uniqueID, this }); 
+			p->zOrderPending.push(this);
 			p->updateChildrenZIndex = true; 
+			LayoutStore::structureDirty = true;
+			HitIndex::changed(p);
 		}
 	}
 	Instance() = delete;
 
-	virtual ~Instance() {}
+	virtual ~Instance() {
+		LayoutStore::structureDirty = true;
+		HitIndex::discard(this);
+	}
 
 	void setParent(Instance* ptr) {
 		if (ptr == this) return;
@@ -1079,17 +2706,26 @@ public:
 				}
 			}
 
+			Parent->zOrderPending.remove(this);
+			HitIndex::changed(Parent);
+
 			if (Parent->childsRemovedInFrame.find(this->uniqueID) == Parent->childsRemovedInFrame.end()) {
 				Parent->childsRemovedInFrame.insert({ this->uniqueID, ptr });
 			}
 		}
 
 		Parent = ptr;
+		zOrderMark.Placed = false;
 		if (ptr) {
 			ptr->Children.push_back(this);
+			ptr->zOrderPending.push(this);
 			ptr->updateChildrenZIndex = true;
 			ptr->childsAddedInFrame.insert({ this->uniqueID, this });
 		}
+
+		invalidateLayout(this);
+		LayoutStore::structureDirty = true;
+		HitIndex::changed(ptr);
 	}
 
 	Instance* findChild(const std::string& name) const {
@@ -1214,6 +2850,7 @@ public:
 	virtual void eventHandler() {
 		for (const auto& [type, func] : events) {
 			if (type == TICK) {
+				tickedInFrame = true;
 				func(this);
 			} else if (type == CHILD_ADDED) {
 				for (auto& [id, ptr] : childsAddedInFrame) {
@@ -1235,6 +2872,7 @@ public:
 	virtual void Update() {
 		if (lastUpdateFrame == framesSinceStart) return;
 		lastUpdateFrame = framesSinceStart;
+		SUI_PROFILE_OBJECT(this);
 
 		if (updateChildrenZIndex) {
 			updateChildren(this);
@@ -1262,49 +2900,19 @@ public:
 
 Instance* getAncestorWhichParentIsScrollFrame(Instance* ptr) {
 	while (ptr->Parent != nullptr and !ptr->__ParentObject) {
-		if (ptr->Parent->Class == SCROLLFRAME) return ptr;
+		if (HasTrait(ptr->Parent->Class, TRAIT_SCROLL)) return ptr;
 		ptr = ptr->Parent;
 	}
 
 	return nullptr;
 }
 
-bool Is2DInheritor(Instance* obj) {
-	if (obj->Class == INSTANCE or
-		obj->Class == LINEEX or
-		obj->Class == STRING_VALUE or
-		obj->Class == BOOL_VALUE or
-		obj->Class == VECTOR2_VALUE or
-		obj->Class == INT_VALUE or
-		obj->Class == FLOAT_VALUE or
-		obj->Class == OBJECT_VALUE or
-		obj->Class == ADDRESS_VALUE or
-		obj->Class == COLOR_VALUE or
-		obj->Class == FOLDER
-		) {
-		return false;
-	}
-
-	return true;
+inline bool Is2DInheritor(Instance* obj) {
+	return ClassTraits[obj->Class] & TRAIT_2D;
 }
 
-bool Is2DInheritor(InstanceType type) {
-	if (type == INSTANCE or
-		type == LINEEX or
-		type == STRING_VALUE or
-		type == BOOL_VALUE or
-		type == VECTOR2_VALUE or
-		type == INT_VALUE or
-		type == FLOAT_VALUE or
-		type == OBJECT_VALUE or
-		type == ADDRESS_VALUE or
-		type == COLOR_VALUE or
-		type == FOLDER
-		) {
-		return false;
-	}
-
-	return true;
+inline bool Is2DInheritor(InstanceType type) {
+	return ClassTraits[type] & TRAIT_2D;
 }
 
 class StringValue : public Instance {
@@ -1426,6 +3034,26 @@ enum SUI_EEC {
 	EEC_IF_DESCENDANT_HIGHER
 };
 
+#if SUI_PROFILER
+inline void countCallback(Instance* obj) {
+	if (Profiler::ObjectCosts and obj) obj->frameCost().Callbacks++;
+}
+
+inline Profiler::ObjectScope::ObjectScope(Instance* obj) {
+	if (!ObjectCosts or obj->frameCost().Timing) return;
+	Obj = obj;
+	Obj->cost.Timing = true;
+	Start = now();
+}
+
+inline Profiler::ObjectScope::~ObjectScope() {
+	if (!Obj) return;
+	Instance::Cost& cost = Obj->frameCost();
+	cost.UpdateTime += now() - Start;
+	cost.Timing = false;
+}
+#endif
+
 class Object2D : public Instance {
 	constexpr static const char* DefaultName = "Object2D";
 	constexpr static InstanceType DefaultClass = OBJECT2D;
@@ -1434,21 +3062,15 @@ class Object2D : public Instance {
 	bool startedOnObject2 = false;
 	bool startedOnObject3 = false;
 
-	bool lastActive = Active;
-	int lastZIndex = ZIndex;
 protected:
 	SpecialVector2 RelativePosition{};
 	SpecialVector2 RelativeSize{};
 	std::vector<std::tuple<EventType, InstanceCallback, MouseButtonType>> events;
 
 	void SameUpdate() {
-		if (Active != lastActive or lastZIndex != ZIndex) {
-			lastActive = Active;
-			lastZIndex = ZIndex;
-			
-			if (Parent) {
-				Parent->updateChildrenZIndex = true;
-			}
+		if (Parent and zOrderKey != ZIndex) { // placed with another ZIndex
+			Parent->zOrderPending.push(this);
+			Parent->updateChildrenZIndex = true;
 		}
 
 		childsRemovedInFrame.clear();
@@ -1458,10 +3080,38 @@ protected:
 	void eventHandler();
 	void PosOrSizeChanged();
 	void updateAncestorWhichParentIsScroll();
+	void sizeChanged();
+
+	void bindVectors() { // copied vectors don't keep their owner, clones have to bind them again
+		layoutIndex = -1;
+		hitIndex = -1;
+		PositionOFFSET.parentalObj = this;
+		SizeOFFSET.parentalObj = this;
+		AnchorPositionOFFSET.parentalObj = this;
+		Position.parentalObj = this;
+		Size.parentalObj = this;
+		AnchorPosition.parentalObj = this;
+	}
+	unsigned int layoutEpochSeen = 0;
+
+	void layoutChanged(bool sizeChanged) { // result differs from cached one, descendants depending on it are computed again
+		sceneDirty = true;
+		HitIndex::moved(this);
+		for (Instance* child : Children) {
+			invalidateLayout(child, sizeChanged);
+		}
+		if (sizeChanged) this->sizeChanged();
+	}
 public:
+	// RealSize and RealPos are cached, these are false when they have to be computed again
 	bool RelativePCalculated = false;
 	bool RelativeSCalculated = false;
+	int layoutIndex = -1; // node in LayoutStore
+	int hitIndex = -1; // entry in HitIndex
 	void VectorChanged() {
+		RelativeSCalculated = false;
+		RelativePCalculated = false;
+		if (layoutIndex >= 0) LayoutStore::write(this);
 		PosOrSizeChanged();
 	}
 
@@ -1475,14 +3125,14 @@ public:
 		return false;
 	}
 
-	SpecialVector2 RealSize{0,0,this}; // Absolute size in pixels (not for changing from somewhere)
+	SpecialVector2 RealSize{}; // Absolute size in pixels (not for changing from somewhere)
 	SpecialVector2 RealPos{}; // Absolute position in pixels (not for changing from somewhere)
 	SUI_EEC EnterEventCondition = SUI_EEC::EEC_DEFAULT;
 	SpecialVector2 PositionOFFSET = { 0,0,this };
-	SpecialVector2 SizeOFFSET = {};
+	SpecialVector2 SizeOFFSET = { 0,0,this };
 	SpecialVector2 AnchorPositionOFFSET = { 0,0,this };
 	SpecialVector2 Position{ 0,0,this };
-	SpecialVector2 Size{};
+	SpecialVector2 Size{ 0,0,this };
 	SpecialVector2 AnchorPosition{ 0,0,this };
 
 	float BackgroundTransparency{};
@@ -1522,7 +3172,11 @@ public:
 		sizePx.y = parentSizePx.y * self->Size.y + self->SizeOFFSET.y;
 
 		RelativeSCalculated = true;
-		RealSize = sizePx;
+		if (RealSize.x != sizePx.x or RealSize.y != sizePx.y) {
+			RealSize = sizePx;
+			RelativePCalculated = false; // anchor depends on own size
+			layoutChanged(true);
+		}
 		RelativeSize = SpecialVector2{ sizePx.x / winWidth, sizePx.y / winHeight };
 	}
 
@@ -1570,7 +3224,7 @@ public:
 				parentSizePx.y * Position.y + PositionOFFSET.y - anchorPx.y
 			};
 
-			if (obj->Class == SCROLLFRAME) {
+			if (HasTrait(obj->Class, TRAIT_SCROLL)) {
 				SpecialVector2 canvasPx = getCanvasRealPos(obj);
 				posPx.x = parentPosPx.x + myLocalPx.x - canvasPx.x;
 				posPx.y = parentPosPx.y + myLocalPx.y - canvasPx.y;
@@ -1580,8 +3234,11 @@ public:
 			}
 
 			RelativePosition = SpecialVector2{ posPx.x / winWidth, posPx.y / winHeight };
-			RealPos = posPx;
 			RelativePCalculated = true;
+			if (RealPos.x != posPx.x or RealPos.y != posPx.y) {
+				RealPos = posPx;
+				layoutChanged(false);
+			}
 			return;
 		}
 
@@ -1591,17 +3248,49 @@ public:
 			rootSizePx.y * Position.y + PositionOFFSET.y - anchorPx.y
 		};
 
-		RealPos = rootLocalPx;
+		if (RealPos.x != rootLocalPx.x or RealPos.y != rootLocalPx.y) {
+			RealPos = rootLocalPx;
+			layoutChanged(false);
+		}
 		RelativePosition = SpecialVector2{ RealPos.x / winWidth, RealPos.y / winHeight };
 		RelativePCalculated = true;
 	}
 
+	void applyStoredLayout(float sizeX, float sizeY, float posX, float posY) { // result of LayoutStore sweep
+		if (RealSize.x != sizeX or RealSize.y != sizeY or RealPos.x != posX or RealPos.y != posY) {
+			bool resized = RealSize.x != sizeX or RealSize.y != sizeY;
+			RealSize = Vector2{ sizeX, sizeY };
+			RealPos = Vector2{ posX, posY };
+			sceneDirty = true;
+			HitIndex::moved(this);
+			if (resized) sizeChanged();
+		}
+		RelativeSize = SpecialVector2{ sizeX / winWidth, sizeY / winHeight };
+		RelativePosition = SpecialVector2{ posX / winWidth, posY / winHeight };
+		RelativeSCalculated = true;
+		RelativePCalculated = true;
+		layoutEpochSeen = layoutEpoch;
+	}
+
+	void updateLayout() { // computes RealSize and RealPos only if something they depend on was changed
+		if (layoutEpochSeen != layoutEpoch) {
+			layoutEpochSeen = layoutEpoch;
+			RelativeSCalculated = false;
+			RelativePCalculated = false;
+		}
+
+		SUI_PROFILE_IF(Profiler::PHASE_LAYOUT, !RelativeSCalculated or !RelativePCalculated);
+		if (!RelativeSCalculated) getRealObject2Dsize();
+		if (!RelativePCalculated) getRealObject2Dposition();
+	}
+
 	SpecialVector2 getMousePosition() {
 		SpecialVector2 mousePos = mousePosition;
 		return { (mousePos.x - RealPos.x) / RealSize.x, (mousePos.y - RealPos.y) / RealSize.y };
 	}
 
 	virtual void Draw() {
+		DrawList::OwnerScope drawOwner(this);
 		if (Visible) {
 			if (RealPos.x + RealSize.x + BorderThickness < 0
 				or RealPos.x - RealSize.x - BorderThickness > winWidth
@@ -1609,13 +3298,14 @@ public:
 				or RealPos.y - RealSize.y - BorderThickness > winHeight) {
 				return;
 			}
+			SUI_COUNT_COST(this, Drawn);
 
 			if (BackgroundTransparency != 1) {
-				DrawRectangleRounded({ RealPos.x, RealPos.y, RealSize.x, RealSize.y }, Roundness, Segments, { BackgroundColor.r, BackgroundColor.g, BackgroundColor.b, (unsigned char)(BackgroundColor.a * (1 - BackgroundTransparency)) });
+				DrawList::RectangleRounded({ RealPos.x, RealPos.y, RealSize.x, RealSize.y }, Roundness, Segments, { BackgroundColor.r, BackgroundColor.g, BackgroundColor.b, (unsigned char)(BackgroundColor.a * (1 - BackgroundTransparency)) });
 			}
 
 			if (BorderThickness > 0) {
-				DrawRectangleRoundedLinesEx({ RealPos.x, RealPos.y, RealSize.x, RealSize.y }, Roundness, Segments, BorderThickness, { BorderColor.r, BorderColor.g, BorderColor.b, (unsigned char)(BorderColor.a * (1 - BorderTransparency)) });
+				DrawList::RectangleRoundedLines({ RealPos.x, RealPos.y, RealSize.x, RealSize.y }, Roundness, Segments, BorderThickness, { BorderColor.r, BorderColor.g, BorderColor.b, (unsigned char)(BorderColor.a * (1 - BorderTransparency)) });
 			}
 		}
 	}
@@ -1631,7 +3321,7 @@ public:
 			mouse.x <= windowPos.x + width and
 			mouse.y >= windowPos.y and
 			mouse.y <= windowPos.y + height)) return false;
-		if (Parent and Parent->Class == SCROLLFRAME) {
+		if (Parent and HasTrait(Parent->Class, TRAIT_SCROLL)) {
 			SpecialVector2 scrRS = getScrollFrameRS(Parent);
 			SpecialVector2 scrRP = getScrollFrameRP(Parent);
 			bool cropping = isScrollFrameCropping(Parent);
@@ -1657,9 +3347,8 @@ public:
 	void Update() override {
 		if (lastUpdateFrame == framesSinceStart) return;
 		lastUpdateFrame = framesSinceStart;
+		SUI_PROFILE_OBJECT(this);
 
-		RelativeSCalculated = false;
-		RelativePCalculated = false;
 		if (!Visible) return;
 
 		SameUpdate();
@@ -1668,8 +3357,7 @@ public:
 			updateChildren(this);
 		}
 
-		getRealObject2Dsize();
-		getRealObject2Dposition();
+		updateLayout();
 		eventHandler();
 		Draw();
 
@@ -1681,6 +3369,7 @@ public:
 
 	Object2D* Clone() const override {
 		Object2D* i = new Object2D(*this);
+		i->bindVectors();
 		i->Parent = nullptr;
 		i->Children.clear();
 		for (Instance* c : Children) {
@@ -1704,6 +3393,11 @@ public:
 		updateAncestorWhichParentIsScroll();
 	}
 
+	~Object2D() { // stores keep pointers until they are built again
+		LayoutStore::forget(this);
+		HitIndex::forget(this);
+	}
+
 	Object2D() = delete;
 };
 
@@ -1711,6 +3405,19 @@ void updateObject2DVector(Object2D* o) {
 	o->VectorChanged();
 }
 
+void invalidateLayout(Instance* obj, bool sizeToo) { // non 2D objects are skipped, their children are laid out by the nearest 2D ancestor
+	if (Is2DInheritor(obj)) {
+		Object2D* casted = static_cast<Object2D*>(obj);
+		if (sizeToo) casted->RelativeSCalculated = false;
+		casted->RelativePCalculated = false;
+		return;
+	}
+
+	for (Instance* child : obj->Children) {
+		invalidateLayout(child, sizeToo);
+	}
+}
+
 class LineEx : public Instance { // it cannot contain Object2D inheritors inside itself  |  only necessary for drawing lines  | Unstable
 	constexpr static const char* DefaultName = "LineEx";
 	constexpr static InstanceType DefaultClass = LINEEX;
@@ -1721,7 +3428,7 @@ class LineEx : public Instance { // it cannot contain Object2D inheritors inside
 		Instance* current = Parent;
 
 		while (current) {
-			Object2D* obj = dynamic_cast<Object2D*>(current);
+			Object2D* obj = Is2DInheritor(current) ? static_cast<Object2D*>(current) : nullptr;
 			if (!obj) {
 				if (current->Parent) {
 					current = current->Parent;
@@ -1737,7 +3444,7 @@ class LineEx : public Instance { // it cannot contain Object2D inheritors inside
 				obj->Position.y - obj->AnchorPosition.y * obj->Size.y
 			};
 
-			if (obj->Class == SCROLLFRAME) {
+			if (HasTrait(obj->Class, TRAIT_SCROLL)) {
 				SpecialVector2 CanvasPosition = getCanvasRealPos(obj);
 
 				pos1.x = parentPos.x + (pos1.x - CanvasPosition.x);
@@ -1769,15 +3476,23 @@ public:
 	bool Visible = true;
 
 	void Draw() {
+		DrawList::OwnerScope drawOwner(this);
 		if (Visible and Thickness) {
+			SUI_COUNT_COST(this, Drawn);
 			auto [pos1, pos2] = getRealObject2Dposition();
-			DrawLineEx(pos1, pos2, Thickness, LineColor);
+			DrawList::Line(pos1, pos2, Thickness, LineColor);
 		}
 	}
 
 	void Update() override {
 		if (lastUpdateFrame == framesSinceStart) return;
 		lastUpdateFrame = framesSinceStart;
+		SUI_PROFILE_OBJECT(this);
+
+		if (Parent and zOrderKey != ZIndex) { // placed with another ZIndex
+			Parent->zOrderPending.push(this);
+			Parent->updateChildrenZIndex = true;
+		}
 
 		eventHandler();
 		Draw();
@@ -1797,30 +3512,60 @@ public:
 	LineEx() = delete;
 };
 
+inline long long zOrderKeyOf(Instance* obj) { // objects without ZIndex go after all others
+	unsigned char traits = ClassTraits[obj->Class];
+	if (!(traits & TRAIT_ZINDEX)) return (long long)std::numeric_limits<int>::max() + 1;
+	if (traits & TRAIT_2D) return static_cast<Object2D*>(obj)->ZIndex;
+	return static_cast<LineEx*>(obj)->ZIndex;
+}
+
+inline unsigned long long zOrderPlacements = 0;
+
+// Children are kept sorted by zOrderKey and then zOrderSequence, so equal ZIndex keeps the order in which children
+// were placed. Only new children and those whose ZIndex changed are placed again: a binary search on the keys they
+// were placed with finds them, erasing and inserting still moves the pointers behind them once.
 inline void updateChildren(Instance* parent) {
 	if (!parent) return;
 	parent->updateChildrenZIndex = false;
 
-	std::sort(parent->Children.begin(), parent->Children.end(), [](Instance* a, Instance* b) {
-		auto az = dynamic_cast<Object2D*>(a);
-		auto bz = dynamic_cast<Object2D*>(b);
+	std::vector<Instance*>& children = parent->Children;
+	std::vector<Instance*>& pending = parent->zOrderPending.items;
+	if (pending.size()) HitIndex::changed(parent);
+	auto before = [](Instance* a, Instance* b) {
+		return a->zOrderKey != b->zOrderKey ? a->zOrderKey < b->zOrderKey : a->zOrderSequence < b->zOrderSequence;
+	};
 
-		LineEx* az2 = nullptr;
-		LineEx* bz2 = nullptr;
+	auto place = [](Instance* child) { // queued children go behind their equals in the order they were queued
+		child->zOrderKey = zOrderKeyOf(child);
+		child->zOrderSequence = ++zOrderPlacements;
+		child->zOrderMark.Placed = true;
+	};
 
-		if (!az and a->Class == LINEEX)
-			az2 = dynamic_cast<LineEx*>(a);
-		if (!bz and b->Class == LINEEX)
-			bz2 = dynamic_cast<LineEx*>(b);
+	if (pending.size() > 16 and pending.size() * 8 > children.size()) { // many changes at once, one sort is cheaper
+		for (Instance* child : pending) place(child);
+		std::sort(children.begin(), children.end(), before);
+		parent->zOrderPending.clear();
+		return;
+	}
 
-		if (az and bz) return az->ZIndex < bz->ZIndex;
-		if (az2 and bz2) return az2->ZIndex < bz2->ZIndex;
-		if (az2 and bz) return az2->ZIndex < bz->ZIndex;
-		if (az and bz2) return az->ZIndex < bz2->ZIndex;
-		if (az) return true;
-		if (bz) return false;
-		return true;
-	});
+	size_t sorted = children.size(); // new children wait behind the sorted ones
+	for (Instance* child : pending) {
+		if (!child->zOrderMark.Placed) sorted--;
+	}
+	children.resize(sorted);
+
+	for (Instance* child : pending) {
+		if (!child->zOrderMark.Placed) continue;
+		auto found = std::lower_bound(children.begin(), children.end(), child, before); // by the keys it was placed with
+		if (found == children.end() or *found != child) found = std::find(children.begin(), children.end(), child);
+		if (found != children.end()) children.erase(found);
+	}
+
+	for (Instance* child : pending) {
+		place(child);
+		children.insert(std::upper_bound(children.begin(), children.end(), child, before), child);
+	}
+	parent->zOrderPending.clear();
 }
 
 inline Font getFont(const std::string& name) {
@@ -1850,18 +3595,327 @@ inline void PushClip(Clip last) {
 		last = Intersect(clipStack.back(), last);
 
 	clipStack.push_back(last);
-	BeginScissorMode(last.x, last.y, last.w, last.h);
+	DrawList::Scissor(last.x, last.y, last.w, last.h);
 }
 
 inline void PopClip() {
-	EndScissorMode();
+	DrawList::EndScissor();
 	clipStack.pop_back();
 	if (!clipStack.empty()) {
 		Clip last = clipStack.back();
-		BeginScissorMode(last.x, last.y, last.w, last.h);
+		DrawList::Scissor(last.x, last.y, last.w, last.h);
+	}
+}
+
+namespace TextAtlas { // cached label text packed into a few shared render targets instead of one render texture per label
+	inline int PageSize = 2048;
+	inline int MaxPages = 4;
+	inline size_t EvictAfterFrames = 120; // slots not drawn for this long give their place to new text
+	inline float DefragmentWaste = 0.25f; // pages with less of their area covered by live slots are not packed again
+
+	struct Slot {
+		const void* Owner = nullptr;
+		int Page = -1;
+		Rectangle Rec{};
+		size_t LastUsed = 0;
+		unsigned long long Version = 0;
+	};
+
+	struct Shelf {
+		float Y, Height, X;
+	};
+
+	struct Page {
+		RenderTexture2D Target{};
+		std::vector<Shelf> Shelves;
+		std::vector<Rectangle> Free; // places of released slots, reused whole
+		float Bottom = 0;
+	};
+
+	inline std::vector<Page> pages;
+	inline std::vector<Slot> slots;
+	inline std::vector<int> freeSlots;
+	inline bool defragmentRequested = false;
+	inline bool releasedSinceDefragment = false; // a full atlas of live text gains nothing from another pass
+	inline bool restoreClip = false;
+	inline Clip restore{};
+
+	inline void beginTarget(const RenderTexture2D& target) { // recorded scissors are not applied yet, applied ones have to be lifted
+		restoreClip = !clipStack.empty() and !DrawList::Recording();
+		if (restoreClip) {
+			restore = clipStack.back();
+			EndScissorMode();
+		}
+		BeginTextureMode(target);
+	}
+
+	inline void endTarget() {
+		EndTextureMode();
+		if (restoreClip) BeginScissorMode(restore.x, restore.y, restore.w, restore.h);
+		restoreClip = false;
+	}
+
+	inline bool place(Page& p, float w, float h, Rectangle& out) {
+		for (size_t i = 0; i < p.Free.size(); i++) {
+			const Rectangle& r = p.Free[i];
+			if (r.width >= w and r.height >= h and r.height <= h * 2) {
+				out = r;
+				p.Free[i] = p.Free.back();
+				p.Free.pop_back();
+				return true;
+			}
+		}
+
+		for (Shelf& shelf : p.Shelves) {
+			if (shelf.Height >= h and shelf.Height <= h * 1.5f and shelf.X + w <= PageSize) {
+				out = { shelf.X, shelf.Y, w, shelf.Height };
+				shelf.X += w;
+				return true;
+			}
+		}
+
+		if (p.Bottom + h > PageSize) return false;
+		p.Shelves.push_back({ p.Bottom, h, w });
+		out = { 0, p.Bottom, w, h };
+		p.Bottom += h;
+		return true;
+	}
+
+	inline bool Valid(int index, const void* owner) {
+		return index >= 0 and index < (int)slots.size() and owner and slots[index].Owner == owner;
+	}
+
+	inline void release(int index) {
+		Slot& slot = slots[index];
+		pages[slot.Page].Free.push_back(slot.Rec);
+		slot.Owner = nullptr;
+		freeSlots.push_back(index);
+		releasedSinceDefragment = true;
+	}
+
+	inline void Release(int index, const void* owner) {
+		if (Valid(index, owner)) release(index);
+	}
+
+	inline void addPage() {
+		Page p;
+		p.Target = LoadRenderTexture(PageSize, PageSize);
+		SetTextureWrap(p.Target.texture, TEXTURE_WRAP_CLAMP);
+		beginTarget(p.Target);
+		ClearBackground(BLANK);
+		endTarget();
+		pages.push_back(std::move(p));
+	}
+
+	inline bool placeAnywhere(float w, float h, int& page, Rectangle& out) {
+		for (page = 0; page < (int)pages.size(); page++) {
+			if (place(pages[page], w, h, out)) return true;
+		}
+		return false;
+	}
+
+	// Space of a w x h slot, -1 when the text does not fit into a page or every page is full.
+	// Stale slots are evicted first, then a page is added, wasted pages are defragmented before the next frame.
+	inline int Allocate(const void* owner, float w, float h) {
+		w = std::ceil(w);
+		h = std::ceil(h / 4) * 4; // similar heights share shelves
+		if (!hasRenderer() or w > PageSize or h > PageSize) return -1;
+
+		int page;
+		Rectangle rec;
+		bool placed = placeAnywhere(w, h, page, rec);
+		if (!placed) {
+			for (int i = 0; i < (int)slots.size(); i++) {
+				if (slots[i].Owner and slots[i].LastUsed + EvictAfterFrames < framesSinceStart) release(i);
+			}
+			placed = placeAnywhere(w, h, page, rec);
+		}
+		if (!placed and (int)pages.size() < MaxPages) {
+			addPage();
+			placed = placeAnywhere(w, h, page, rec);
+		}
+		if (!placed) {
+			if (releasedSinceDefragment) defragmentRequested = true;
+			return -1;
+		}
+
+		int index;
+		if (freeSlots.empty()) {
+			index = (int)slots.size();
+			slots.emplace_back();
+		} else {
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+
+		Slot& slot = slots[index];
+		unsigned long long version = slot.Version + 1;
+		slot = { owner, page, rec, framesSinceStart, version };
+		return index;
+	}
+
+	inline void defragment(int page) { // live slots are packed again by height into a new target
+		Page& p = pages[page];
+		std::vector<int> live;
+		for (int i = 0; i < (int)slots.size(); i++) {
+			if (slots[i].Owner and slots[i].Page == page) live.push_back(i);
+		}
+		std::sort(live.begin(), live.end(), [](int a, int b) { return slots[a].Rec.height > slots[b].Rec.height; });
+
+		RenderTexture2D old = p.Target;
+		p.Target = LoadRenderTexture(PageSize, PageSize);
+		SetTextureWrap(p.Target.texture, TEXTURE_WRAP_CLAMP);
+		p.Shelves.clear();
+		p.Free.clear();
+		p.Bottom = 0;
+
+		beginTarget(p.Target);
+		ClearBackground(BLANK);
+		rlDrawRenderBatchActive();
+		rlDisableColorBlend(); // alpha of the text is copied as it is
+		for (int i : live) {
+			Slot& slot = slots[i];
+			Rectangle rec;
+			if (!place(p, slot.Rec.width, slot.Rec.height, rec)) {
+				slot.Owner = nullptr; // drawn again by its label
+				freeSlots.push_back(i);
+				continue;
+			}
+			DrawTexturePro(old.texture, { slot.Rec.x, PageSize - slot.Rec.y - slot.Rec.height, slot.Rec.width, -slot.Rec.height }, rec, { 0,0 }, 0, { 255,255,255,255 });
+			slot.Rec = rec;
+			slot.Version++;
+		}
+		rlDrawRenderBatchActive();
+		rlEnableColorBlend();
+		endTarget();
+
+		DrawList::ReleaseTexture(old.texture.id);
+		UnloadRenderTexture(old);
+	}
+
+	inline void Maintain() { // between frames, nothing recorded can point into a page
+		if (!defragmentRequested) return;
+		defragmentRequested = false;
+		releasedSinceDefragment = false;
+
+		std::vector<float> live(pages.size(), 0.0f);
+		for (const Slot& slot : slots) {
+			if (slot.Owner) live[slot.Page] += slot.Rec.width * slot.Rec.height;
+		}
+		float area = (float)PageSize * PageSize;
+		for (int i = 0; i < (int)pages.size(); i++) {
+			if (area - live[i] >= area * DefragmentWaste) defragment(i);
+		}
+	}
+
+	inline void Shutdown() {
+		for (Page& p : pages) {
+			DrawList::ReleaseTexture(p.Target.texture.id);
+			UnloadRenderTexture(p.Target);
+		}
+		pages.clear();
+		slots.clear();
+		freeSlots.clear();
 	}
 }
 
+struct TextCache { // text of one label drawn once, into a TextAtlas slot or an own render texture when the atlas has no place
+	const void* Owner = nullptr;
+	int Slot = -1;
+	RenderTexture2D Own{};
+	Vector2 Capacity{};
+
+	bool Valid() const {
+		return Own.id != 0 or TextAtlas::Valid(Slot, Owner);
+	}
+
+	void Release() {
+		TextAtlas::Release(Slot, Owner);
+		if (Own.id != 0) {
+			DrawList::ReleaseTexture(Own.texture.id);
+			UnloadRenderTexture(Own);
+		}
+		Slot = -1;
+		Own = {};
+		Capacity = {};
+	}
+
+	void Reserve(const void* owner, Vector2 size, float aspect) { // grows by aspect so small changes are redrawn in place
+		if (Valid() and Owner == owner and Capacity.x >= size.x and Capacity.y >= size.y) return;
+		Release();
+		if (!hasRenderer()) return;
+
+		Owner = owner;
+		Capacity = { size.x * aspect, size.y * aspect };
+		Slot = TextAtlas::Allocate(owner, Capacity.x, Capacity.y);
+		if (Slot >= 0) {
+			Capacity = { TextAtlas::slots[Slot].Rec.width, TextAtlas::slots[Slot].Rec.height };
+		} else {
+			Own = LoadRenderTexture(Capacity.x, Capacity.y);
+			SetTextureWrap(Own.texture, TEXTURE_WRAP_CLAMP);
+		}
+	}
+
+	Vector2 Origin() const {
+		if (Own.id or Slot < 0) return { 0, 0 };
+		return { TextAtlas::slots[Slot].Rec.x, TextAtlas::slots[Slot].Rec.y };
+	}
+
+	bool Begin() { // text is drawn at Origin until End
+		if (!Valid()) return false;
+		if (Own.id) {
+			TextAtlas::beginTarget(Own);
+			ClearBackground(BLANK);
+			return true;
+		}
+
+		TextAtlas::Slot& slot = TextAtlas::slots[Slot];
+		slot.LastUsed = framesSinceStart;
+		TextAtlas::beginTarget(TextAtlas::pages[slot.Page].Target);
+		BeginScissorMode((int)slot.Rec.x, (int)slot.Rec.y, (int)slot.Rec.width, (int)slot.Rec.height);
+		ClearBackground(BLANK);
+		return true;
+	}
+
+	void End() {
+		if (Own.id) {
+			TextAtlas::endTarget();
+			DrawList::TextureChanged(Own.texture.id);
+			return;
+		}
+
+		EndScissorMode();
+		TextAtlas::endTarget();
+		TextAtlas::slots[Slot].Version++;
+	}
+
+	void Draw(Rectangle region, Vector2 position, Color tint) { // region of the cached text, clipped to what was reserved
+		Texture2D tex{};
+		Vector2 base{};
+		unsigned long long version = 0;
+		if (Own.id) {
+			tex = Own.texture;
+		} else if (Valid()) {
+			TextAtlas::Slot& slot = TextAtlas::slots[Slot];
+			slot.LastUsed = framesSinceStart;
+			tex = TextAtlas::pages[slot.Page].Target.texture;
+			base = { slot.Rec.x, slot.Rec.y };
+			version = slot.Version;
+		}
+
+		if (tex.id) {
+			if (region.x < 0) { position.x -= region.x; region.width += region.x; region.x = 0; }
+			if (region.y < 0) { position.y -= region.y; region.height += region.y; region.y = 0; }
+			region.width = std::min(region.width, Capacity.x - region.x);
+			region.height = std::min(region.height, Capacity.y - region.y);
+			if (region.width <= 0 or region.height <= 0) return;
+		}
+
+		Rectangle source = { base.x + region.x, tex.height - base.y - region.y - region.height, region.width, -region.height };
+		DrawList::TexturePro(tex, source, { position.x, position.y, region.width, region.height }, { 0, 0 }, 0, tint, version);
+	}
+};
+
 class ScrollFrame : public Object2D {
 	constexpr static const char* DefaultName = "ScrollFrame";
 	constexpr static InstanceType DefaultClass = SCROLLFRAME;
@@ -1988,6 +4042,8 @@ private:
 			SectorsOnObject[obj->uniqueID].push_back(sector);
 		}
 	}
+public:
+	SpecialVector2 lastCanvasPx{}; // canvas offset children were laid out with
 private:
 	SpecialVector2 lastFullSize{};
 	SpecialVector2 lastCanvasFullPosition{};
@@ -2037,6 +4093,7 @@ private:
 	}
 
 	std::unordered_map<long, Instance*> toUpdateSectors;
+	std::unordered_map<long, Instance*> updatingSectors; // sizes computed by secUpd can queue objects again, they wait for the next frame
 	void secUpd(Instance* child) {
 		if (!child) return;
 		auto checkIt = SectorsOnObject.find(child->uniqueID);
@@ -2096,6 +4153,7 @@ public:
 	bool Animated = false;
 
 	void Draw(bool force=false) {
+		DrawList::OwnerScope drawOwner(this);
 		Object2D::Draw();
 
 		bool pushed = false;
@@ -2104,11 +4162,12 @@ public:
 			pushed = true;
 		}
 
-		for (auto& [id, ptr] : toUpdateSectors) {
+		std::swap(updatingSectors, toUpdateSectors);
+		for (auto& [id, ptr] : updatingSectors) {
 			secUpd(ptr);
 		}
 
-		toUpdateSectors.clear();
+		updatingSectors.clear();
 
 		for (ScrollSector* s : sectorsOnView) {
 			for (auto& [id, ptr] : s->Objects) {
@@ -2145,7 +4204,7 @@ public:
 
 					SpecialVector2 firstPoint = { RealPos.x + RealSize.x - SliderSize * 0.6f, sliderY };
 					SpecialVector2 secondPoint = { firstPoint.x, sliderY + sliderHeight };
-					DrawLineEx(firstPoint, secondPoint, SliderSize, { SliderColor.r, SliderColor.g, SliderColor.b, (unsigned char)(SliderColor.a * (1 - SliderTransparency)) });
+					DrawList::Line(firstPoint, secondPoint, SliderSize, { SliderColor.r, SliderColor.g, SliderColor.b, (unsigned char)(SliderColor.a * (1 - SliderTransparency)) });
 				}
 			}
 
@@ -2167,7 +4226,7 @@ public:
 
 					SpecialVector2 firstPoint = { sliderX, RealPos.y + RealSize.y - SliderSize * 0.6f };
 					SpecialVector2 secondPoint = { sliderX + sliderWidth, firstPoint.y };
-					DrawLineEx(firstPoint, secondPoint, SliderSize, { SliderColor.r, SliderColor.g, SliderColor.b, (unsigned char)(SliderColor.a * (1 - SliderTransparency)) });
+					DrawList::Line(firstPoint, secondPoint, SliderSize, { SliderColor.r, SliderColor.g, SliderColor.b, (unsigned char)(SliderColor.a * (1 - SliderTransparency)) });
 				}
 			}
 		}
@@ -2176,6 +4235,7 @@ public:
 	void Update() override {
 		if (lastUpdateFrame == framesSinceStart) return;
 		lastUpdateFrame = framesSinceStart;
+		SUI_PROFILE_OBJECT(this);
 
 		if (!Visible) return;
 		if (CanvasSize.x < 0) CanvasSize.x = 0; if (CanvasSize.y < 0) CanvasSize.y = 0;
@@ -2183,8 +4243,7 @@ public:
 			Direction = 'Y';
 		}
 
-		getRealObject2Dsize();
-		getRealObject2Dposition();
+		updateLayout();
 		eventHandler();
 
 		bool force = false;
@@ -2281,12 +4340,19 @@ public:
 			}
 		}
 
+		SpecialVector2 canvasPx = getCanvasRealPos(this);
+		if (canvasPx.x != lastCanvasPx.x or canvasPx.y != lastCanvasPx.y) {
+			lastCanvasPx = canvasPx;
+			layoutChanged(false);
+		}
+
 		checkAndUpdateCurrentSectors();
 		Draw(force);
 	}
 
 	ScrollFrame* Clone() const override {
 		ScrollFrame* i = new ScrollFrame(*this);
+		i->bindVectors();
 		i->Parent = nullptr;
 		i->Children.clear();
 		for (Instance* c : Children) {
@@ -2318,8 +4384,22 @@ inline void Object2D::updateAncestorWhichParentIsScroll() {
 	}
 }
 
+inline void Object2D::sizeChanged() { // ScrollFrame sectors come from sizes, culled children would keep the old ones
+	updateAncestorWhichParentIsScroll();
+	if (!HasTrait(Class, TRAIT_SCROLL)) return;
+
+	ScrollFrame* scroll = static_cast<ScrollFrame*>(this);
+	for (Instance* child : Children) {
+		if (Is2DInheritor(child)) {
+			Object2D* casted = static_cast<Object2D*>(child);
+			if (casted->Size.x == 0 and casted->Size.y == 0 and casted->Position.x == 0 and casted->Position.y == 0) continue;
+		}
+		scroll->UpdateSectors(child);
+	}
+}
+
 inline SpecialVector2 getCanvasRealPos(Object2D* obj) {
-	if (obj->Class == SCROLLFRAME) {
+	if (HasTrait(obj->Class, TRAIT_SCROLL)) {
 		ScrollFrame* scra = static_cast<ScrollFrame*>(obj);
 		return
 		{
@@ -2331,7 +4411,7 @@ inline SpecialVector2 getCanvasRealPos(Object2D* obj) {
 }
 
 inline SpecialVector2 getScrollFrameRS(Instance* sc) {
-	if (sc->Class == SCROLLFRAME) {
+	if (HasTrait(sc->Class, TRAIT_SCROLL)) {
 		ScrollFrame* scra = static_cast<ScrollFrame*>(sc);
 		return scra->RealSize;
 	}
@@ -2339,7 +4419,7 @@ inline SpecialVector2 getScrollFrameRS(Instance* sc) {
 	return { 0,0 };
 }
 inline SpecialVector2 getScrollFrameRP(Instance* sc) {
-	if (sc->Class == SCROLLFRAME) {
+	if (HasTrait(sc->Class, TRAIT_SCROLL)) {
 		ScrollFrame* scra = static_cast<ScrollFrame*>(sc);
 		return scra->RealPos;
 	}
@@ -2347,7 +4427,7 @@ inline SpecialVector2 getScrollFrameRP(Instance* sc) {
 	return { 0,0 };
 }
 inline bool isScrollFrameCropping(Instance* sc) {
-	if (sc->Class == SCROLLFRAME) {
+	if (HasTrait(sc->Class, TRAIT_SCROLL)) {
 		ScrollFrame* scra = static_cast<ScrollFrame*>(sc);
 		return scra->CropDescendants;
 	}
@@ -2355,6 +4435,397 @@ inline bool isScrollFrameCropping(Instance* sc) {
 	return false;
 }
 
+namespace LayoutStore {
+	// Nodes are in breadth first order, so parents come before children and siblings are next to each other.
+	// Inputs are written through from SpecialVector2 notifications, results are copied back into the objects.
+	inline std::vector<Object2D*> Nodes;
+	inline std::vector<int> SizeParent; // node whose RealSize is used for size, -1 is window
+	inline std::vector<int> PosParent; // node whose RealPos and RealSize are used for position, -1 is window
+	inline std::vector<unsigned char> Scroll;
+	inline std::vector<float> PositionX, PositionY, PositionOffsetX, PositionOffsetY;
+	inline std::vector<float> SizeX, SizeY, SizeOffsetX, SizeOffsetY;
+	inline std::vector<float> AnchorX, AnchorY, AnchorOffsetX, AnchorOffsetY;
+	inline std::vector<float> RealSizeX, RealSizeY, RealPosX, RealPosY;
+	inline std::vector<float> CanvasX, CanvasY; // only for ScrollFrame nodes
+	inline std::vector<float> PrevSizeX, PrevSizeY, PrevPosX, PrevPosY; // results of previous sweep, only changed ones are copied back
+	inline std::vector<unsigned char> Touched; // inputs were written since last sweep
+	inline bool applyAll = true;
+	inline std::vector<int> scrollNodes;
+	inline std::vector<Instance*> queue;
+	inline Instance* root = nullptr;
+	inline int solvedWidth = 0;
+	inline int solvedHeight = 0;
+
+	inline void write(Object2D* obj) {
+		if (!Enabled or structureDirty) return;
+		int i = obj->layoutIndex;
+		if (i < 0 or i >= (int)Nodes.size() or Nodes[i] != obj) return;
+
+		PositionX[i] = obj->Position.x; PositionY[i] = obj->Position.y;
+		PositionOffsetX[i] = obj->PositionOFFSET.x; PositionOffsetY[i] = obj->PositionOFFSET.y;
+		SizeX[i] = obj->Size.x; SizeY[i] = obj->Size.y;
+		SizeOffsetX[i] = obj->SizeOFFSET.x; SizeOffsetY[i] = obj->SizeOFFSET.y;
+		AnchorX[i] = obj->AnchorPosition.x; AnchorY[i] = obj->AnchorPosition.y;
+		AnchorOffsetX[i] = obj->AnchorPositionOFFSET.x; AnchorOffsetY[i] = obj->AnchorPositionOFFSET.y;
+		Touched[i] = 1;
+		valuesDirty = true;
+	}
+
+	inline void forget(Object2D* obj) {
+		int i = obj->layoutIndex;
+		if (i >= 0 and i < (int)Nodes.size() and Nodes[i] == obj) Nodes[i] = nullptr;
+	}
+
+	inline int nearest2D(Instance* obj, bool stopAtRoot) { // same ancestor search as getRealObject2Dsize / getRealObject2Dposition
+		Instance* current = obj->Parent;
+		while (current) {
+			if (!Is2DInheritor(current)) { current = current->Parent; continue; }
+			Object2D* casted = static_cast<Object2D*>(current);
+			if (stopAtRoot and casted->__ParentObject) return -1;
+			return casted->layoutIndex;
+		}
+		return -1;
+	}
+
+	// Independent subtrees: every top level object and the content of every ScrollFrame.
+	// A segment only reads results of its own nodes and of the segment that owns it.
+	struct Segment {
+		int begin, end; // nodes
+		int childBegin, childEnd; // segments of ScrollFrames inside, they can be solved once this one is done
+	};
+	inline std::vector<Segment> Segments;
+	inline int topSegments = 0;
+	inline std::vector<std::vector<Instance*>> segmentStarts;
+
+	inline void collect2D(Instance* obj, std::vector<Instance*>& out) { // nearest Object2D descendants
+		for (Instance* child : obj->Children) {
+			if (Is2DInheritor(child)) out.push_back(child);
+			else collect2D(child, out);
+		}
+	}
+
+	inline void build(Instance* start) {
+		for (Object2D* obj : Nodes) if (obj) obj->layoutIndex = -1;
+		Nodes.clear();
+		SizeParent.clear();
+		PosParent.clear();
+		Scroll.clear();
+		scrollNodes.clear();
+		Segments.clear();
+
+		segmentStarts.clear();
+		queue.clear();
+		collect2D(start, queue);
+		for (Instance* top : queue) segmentStarts.push_back({ top });
+		topSegments = (int)segmentStarts.size();
+
+		// segments are in breadth first order too, nodes of a segment are contiguous
+		for (size_t s = 0; s < segmentStarts.size(); s++) {
+			Segment segment{ (int)Nodes.size(), 0, (int)segmentStarts.size(), 0 };
+			queue = segmentStarts[s];
+
+			for (size_t q = 0; q < queue.size(); q++) {
+				Object2D* obj = static_cast<Object2D*>(queue[q]);
+				obj->layoutIndex = (int)Nodes.size();
+				Nodes.push_back(obj);
+				SizeParent.push_back(nearest2D(obj, true));
+				PosParent.push_back(nearest2D(obj, false));
+				Scroll.push_back(HasTrait(obj->Class, TRAIT_SCROLL));
+
+				if (HasTrait(obj->Class, TRAIT_SCROLL)) {
+					scrollNodes.push_back(obj->layoutIndex);
+					std::vector<Instance*> content;
+					collect2D(obj, content);
+					if (content.size()) segmentStarts.push_back(std::move(content));
+				} else {
+					collect2D(obj, queue);
+				}
+			}
+
+			segment.end = (int)Nodes.size();
+			segment.childEnd = (int)segmentStarts.size();
+			Segments.push_back(segment);
+		}
+		segmentStarts.clear();
+
+		size_t n = Nodes.size();
+		for (auto* v : { &PositionX, &PositionY, &PositionOffsetX, &PositionOffsetY, &SizeX, &SizeY, &SizeOffsetX, &SizeOffsetY,
+			&AnchorX, &AnchorY, &AnchorOffsetX, &AnchorOffsetY, &RealSizeX, &RealSizeY, &RealPosX, &RealPosY, &CanvasX, &CanvasY,
+			&PrevSizeX, &PrevSizeY, &PrevPosX, &PrevPosY }) {
+			v->assign(n, 0.0f);
+		}
+		Touched.assign(n, 0);
+		applyAll = true;
+
+		structureDirty = false;
+		for (Object2D* obj : Nodes) write(obj);
+		root = start;
+		valuesDirty = true;
+	}
+
+	inline bool Vectorized = true; // siblings are solved with SSE/AVX when the compiler targets it
+
+	enum RunMode { ROOT, CHILD, SCROLL_CHILD };
+
+	// One axis of a run of siblings. Float operations are done in the same order as in
+	// getRealObject2Dsize and getRealObject2Dposition (without FMA), results are bit identical.
+	inline void solveAxisScalar(size_t from, size_t to, const float* scale, const float* offset, const float* anchor, const float* anchorOffset,
+		const float* pos, const float* posOffset, float* outSize, float* outPos, float parentSize, float posParentSize, float parentPos, float canvas, RunMode mode) {
+		for (size_t k = from; k < to; k++) {
+			float size = parentSize * scale[k] + offset[k];
+			outSize[k] = size;
+			float anchorPx = size * anchor[k] + anchorOffset[k];
+			float local = posParentSize * pos[k] + posOffset[k] - anchorPx;
+			if (mode == ROOT) outPos[k] = local;
+			else if (mode == CHILD) outPos[k] = parentPos + local;
+			else outPos[k] = parentPos + local - canvas;
+		}
+	}
+
+	inline void solveAxis(size_t from, size_t to, const float* scale, const float* offset, const float* anchor, const float* anchorOffset,
+		const float* pos, const float* posOffset, float* outSize, float* outPos, float parentSize, float posParentSize, float parentPos, float canvas, RunMode mode) {
+		size_t k = from;
+		if (Vectorized) {
+#if defined(__AVX__)
+			__m256 ps = _mm256_set1_ps(parentSize), pps = _mm256_set1_ps(posParentSize), pp = _mm256_set1_ps(parentPos), cv = _mm256_set1_ps(canvas);
+			for (; k + 8 <= to; k += 8) {
+				__m256 size = _mm256_add_ps(_mm256_mul_ps(ps, _mm256_loadu_ps(scale + k)), _mm256_loadu_ps(offset + k));
+				_mm256_storeu_ps(outSize + k, size);
+				__m256 anchorPx = _mm256_add_ps(_mm256_mul_ps(size, _mm256_loadu_ps(anchor + k)), _mm256_loadu_ps(anchorOffset + k));
+				__m256 local = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(pps, _mm256_loadu_ps(pos + k)), _mm256_loadu_ps(posOffset + k)), anchorPx);
+				if (mode == CHILD) local = _mm256_add_ps(pp, local);
+				else if (mode == SCROLL_CHILD) local = _mm256_sub_ps(_mm256_add_ps(pp, local), cv);
+				_mm256_storeu_ps(outPos + k, local);
+			}
+#endif
+#if defined(__AVX__) or defined(__SSE2__) or defined(_M_X64) or (defined(_M_IX86_FP) and _M_IX86_FP >= 2)
+			__m128 ps4 = _mm_set1_ps(parentSize), pps4 = _mm_set1_ps(posParentSize), pp4 = _mm_set1_ps(parentPos), cv4 = _mm_set1_ps(canvas);
+			for (; k + 4 <= to; k += 4) {
+				__m128 size = _mm_add_ps(_mm_mul_ps(ps4, _mm_loadu_ps(scale + k)), _mm_loadu_ps(offset + k));
+				_mm_storeu_ps(outSize + k, size);
+				__m128 anchorPx = _mm_add_ps(_mm_mul_ps(size, _mm_loadu_ps(anchor + k)), _mm_loadu_ps(anchorOffset + k));
+				__m128 local = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(pps4, _mm_loadu_ps(pos + k)), _mm_loadu_ps(posOffset + k)), anchorPx);
+				if (mode == CHILD) local = _mm_add_ps(pp4, local);
+				else if (mode == SCROLL_CHILD) local = _mm_sub_ps(_mm_add_ps(pp4, local), cv4);
+				_mm_storeu_ps(outPos + k, local);
+			}
+#endif
+		}
+
+		solveAxisScalar(k, to, scale, offset, anchor, anchorOffset, pos, posOffset, outSize, outPos, parentSize, posParentSize, parentPos, canvas, mode);
+	}
+
+	// Siblings share their parents, so every run of them is solved as one batch. Parents always come before the run.
+	inline void sweep(size_t from, size_t n) {
+		const float winW = (float)winWidth, winH = (float)winHeight;
+
+		for (size_t i = from; i < n;) {
+			int sp = SizeParent[i];
+			int pp = PosParent[i];
+			size_t end = i + 1;
+			while (end < n and SizeParent[end] == sp and PosParent[end] == pp) end++;
+
+			RunMode mode = pp < 0 ? ROOT : (Scroll[pp] ? SCROLL_CHILD : CHILD);
+			float parentW = sp >= 0 ? RealSizeX[sp] : winW;
+			float parentH = sp >= 0 ? RealSizeY[sp] : winH;
+			float posParentW = pp >= 0 ? RealSizeX[pp] : winW;
+			float posParentH = pp >= 0 ? RealSizeY[pp] : winH;
+			float parentX = pp >= 0 ? RealPosX[pp] : 0;
+			float parentY = pp >= 0 ? RealPosY[pp] : 0;
+			float canvasX = pp >= 0 ? CanvasX[pp] : 0;
+			float canvasY = pp >= 0 ? CanvasY[pp] : 0;
+
+			solveAxis(i, end, SizeX.data(), SizeOffsetX.data(), AnchorX.data(), AnchorOffsetX.data(), PositionX.data(), PositionOffsetX.data(),
+				RealSizeX.data(), RealPosX.data(), parentW, posParentW, parentX, canvasX, mode);
+			solveAxis(i, end, SizeY.data(), SizeOffsetY.data(), AnchorY.data(), AnchorOffsetY.data(), PositionY.data(), PositionOffsetY.data(),
+				RealSizeY.data(), RealPosY.data(), parentH, posParentH, parentY, canvasY, mode);
+
+			for (size_t k = i; k < end; k++) {
+				if (!Scroll[k]) continue;
+				ScrollFrame* scroll = static_cast<ScrollFrame*>(Nodes[k]);
+				CanvasX[k] = scroll->CanvasPosition.x * RealSizeX[k] + scroll->CanvasPositionOFFSET.x;
+				CanvasY[k] = scroll->CanvasPosition.y * RealSizeY[k] + scroll->CanvasPositionOFFSET.y;
+			}
+
+			i = end;
+		}
+	}
+
+	inline void sweep() {
+		sweep(0, Nodes.size());
+	}
+
+	// Work stealing pool: every thread pops its own tasks from the back and steals from the front of others.
+	// A task is a run of sibling segments, finishing it pushes the segments inside it.
+	inline size_t MinTaskNodes = 2048; // small sibling segments are solved together
+	inline size_t ParallelMinNodes = 16384; // smaller trees are solved on the main thread
+
+	struct Task { int first, last; };
+	struct Worker {
+		std::mutex mtx;
+		std::deque<Task> tasks;
+	};
+	inline std::vector<std::unique_ptr<Worker>> workers; // 0 is the main thread
+	inline std::vector<std::thread> threads;
+	inline std::mutex poolMtx;
+	inline std::condition_variable poolWake;
+	inline unsigned int generation = 0;
+	inline bool stopping = false;
+	inline std::atomic<int> remaining = 0; // segments not solved yet in this frame
+
+	inline void pushTasks(Worker& worker, int from, int to) {
+		if (from >= to) return;
+		std::lock_guard<std::mutex> lock(worker.mtx);
+		for (int s = from; s < to;) {
+			int e = s + 1;
+			size_t nodes = Segments[s].end - Segments[s].begin;
+			while (e < to and nodes < MinTaskNodes) {
+				nodes += Segments[e].end - Segments[e].begin;
+				e++;
+			}
+			worker.tasks.push_back(Task{ s, e });
+			s = e;
+		}
+	}
+
+	inline bool popTask(size_t self, Task& task) {
+		{
+			Worker& own = *workers[self];
+			std::lock_guard<std::mutex> lock(own.mtx);
+			if (own.tasks.size()) {
+				task = own.tasks.back();
+				own.tasks.pop_back();
+				return true;
+			}
+		}
+
+		for (size_t k = 1; k < workers.size(); k++) {
+			Worker& victim = *workers[(self + k) % workers.size()];
+			std::lock_guard<std::mutex> lock(victim.mtx);
+			if (victim.tasks.size()) {
+				task = victim.tasks.front();
+				victim.tasks.pop_front();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	inline void runTasks(size_t self) {
+		Task task{};
+		while (remaining.load(std::memory_order_acquire) > 0) {
+			if (!popTask(self, task)) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			sweep(Segments[task.first].begin, Segments[task.last - 1].end);
+			pushTasks(*workers[self], Segments[task.first].childBegin, Segments[task.last - 1].childEnd);
+			remaining.fetch_sub(task.last - task.first, std::memory_order_acq_rel);
+		}
+	}
+
+	inline void workerLoop(size_t self) {
+		unsigned int seen = 0;
+		while (true) {
+			{
+				std::unique_lock<std::mutex> lock(poolMtx);
+				poolWake.wait(lock, [&seen]() { return stopping or generation != seen; });
+				if (stopping) return;
+				seen = generation;
+			}
+			runTasks(self);
+		}
+	}
+
+	inline void StopThreads() {
+		{
+			std::lock_guard<std::mutex> lock(poolMtx);
+			stopping = true;
+		}
+		poolWake.notify_all();
+		for (std::thread& thread : threads) thread.join();
+		threads.clear();
+		workers.clear();
+		stopping = false;
+	}
+
+	inline void StartThreads(int count) {
+		StopThreads();
+		Threads = std::max(1, count);
+		if (Threads == 1) return;
+
+		for (int i = 0; i < Threads; i++) workers.push_back(std::make_unique<Worker>());
+		for (int i = 1; i < Threads; i++) threads.emplace_back(workerLoop, (size_t)i);
+	}
+
+	struct ThreadsGuard {
+		~ThreadsGuard() { StopThreads(); }
+	};
+	inline ThreadsGuard threadsGuard; // joins the threads at exit if start() did not
+
+	// Every node is computed by the same code from the same inputs as in the serial sweep, so results are bit identical
+	inline void sweepParallel() {
+		if (threads.empty() or Nodes.size() < ParallelMinNodes or Segments.size() < 2) {
+			sweep();
+			return;
+		}
+
+		remaining.store((int)Segments.size(), std::memory_order_release);
+		pushTasks(*workers[0], 0, topSegments);
+		{
+			std::lock_guard<std::mutex> lock(poolMtx);
+			generation++;
+		}
+		poolWake.notify_all();
+		runTasks(0);
+	}
+
+	inline void Solve(Instance* start) { // called by DrawFrame when enabled, objects which were not changed since are not computed again in Update
+		if (!Enabled) return;
+		if (structureDirty or root != start) build(start);
+
+		if (solvedWidth != winWidth or solvedHeight != winHeight) {
+			solvedWidth = winWidth;
+			solvedHeight = winHeight;
+			valuesDirty = true;
+			applyAll = true;
+		}
+
+		for (int i : scrollNodes) {
+			ScrollFrame* scroll = static_cast<ScrollFrame*>(Nodes[i]);
+			if (scroll->CanvasPosition.x * RealSizeX[i] + scroll->CanvasPositionOFFSET.x != CanvasX[i]
+				or scroll->CanvasPosition.y * RealSizeY[i] + scroll->CanvasPositionOFFSET.y != CanvasY[i]) {
+				valuesDirty = true;
+				break;
+			}
+		}
+
+		if (!valuesDirty) return;
+		valuesDirty = false;
+
+		std::swap(RealSizeX, PrevSizeX);
+		std::swap(RealSizeY, PrevSizeY);
+		std::swap(RealPosX, PrevPosX);
+		std::swap(RealPosY, PrevPosY);
+		sweepParallel();
+
+		// objects are scattered in memory, so only those whose result or inputs changed are touched
+		for (size_t i = 0; i < Nodes.size(); i++) {
+			if (applyAll or Touched[i] or RealSizeX[i] != PrevSizeX[i] or RealSizeY[i] != PrevSizeY[i] or RealPosX[i] != PrevPosX[i] or RealPosY[i] != PrevPosY[i]) {
+				Nodes[i]->applyStoredLayout(RealSizeX[i], RealSizeY[i], RealPosX[i], RealPosY[i]);
+				Touched[i] = 0;
+			}
+		}
+
+		for (int i : scrollNodes) {
+			static_cast<ScrollFrame*>(Nodes[i])->lastCanvasPx = Vector2{ CanvasX[i], CanvasY[i] };
+		}
+		applyAll = false;
+	}
+}
+
 class TextLabel : public Object2D {
 	constexpr static float TextTextureUpdateAspect = 1.1;
 	constexpr static const char* DefaultName = "TextLabel";
@@ -2364,11 +4835,17 @@ class TextLabel : public Object2D {
 	int lastMaxVisible = -1;
 	Vector3 textParams{};
 	SpecialVector2 lastRealSize{};
-	RenderTexture2D cachedText{};
+	TextCache cachedText;
 	SpecialVector2 newSize{};
-	SpecialVector2 lastNewSize{};
 	Vector3 lastParams = Vector3{};
 	std::vector<int> charOffsets;
+	TextMetrics metrics; // of visibleText, sizes for a new RealSize are solved without measuring again
+	GlyphLayout glyphs;
+	TextRenderMode lastRenderMode = TextRenderMode::GLYPHS;
+
+	bool needsTexture() const {
+		return RenderMode == TextRenderMode::TEXTURE and !cachedText.Valid() and hasRenderer();
+	}
 
 	void updateCharOffsets() {
 		charOffsets.clear();
@@ -2385,6 +4862,8 @@ class TextLabel : public Object2D {
 	}
 
 	void updateTexture() {
+		SUI_PROFILE(Profiler::PHASE_TEXT);
+		SUI_COUNT_COST(this, TextRegens);
 		updateCharOffsets();
 
 		if (MaxVisibleSymbols > 0 and MaxVisibleSymbols < charOffsets.size()) {
@@ -2401,38 +4880,26 @@ class TextLabel : public Object2D {
 			visibleText = !Text;
 		}
 
-		textParams = getTextCFrame(visibleText.c_str(), getFont(!FontFace), { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
+		metrics = MetricsCache::Get(getFont(!FontFace), visibleText);
+		textParams = getTextCFrame(metrics, { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
 		lastRealSize = RealSize;
 		lastParams = textParams;
 		lastMaxVisible = MaxVisibleSymbols;
 
-		newSize = MeasureTextEx(getFont(!FontFace), visibleText.c_str(), textParams.z, Spacing);
-
-		if (cachedText.id == 0 or lastNewSize.x < newSize.x or lastNewSize.y < newSize.y) {
-			if (cachedText.id != 0) {
-				UnloadRenderTexture(cachedText);
-			}
-			
-			if (Text.size()) {
-				cachedText = LoadRenderTexture(newSize.x * TextTextureUpdateAspect, newSize.y * TextTextureUpdateAspect);
-				lastNewSize = SpecialVector2{ newSize.x * TextTextureUpdateAspect, newSize.y * TextTextureUpdateAspect };
-			}
-		}
-
-		if (cachedText.id) {
-			bool hadClip = !clipStack.empty();
-			Clip current;
-			if (hadClip) current = clipStack.back();
-
-			if (hadClip) EndScissorMode();
+		newSize = metrics.At(textParams.z, Spacing);
 
-			BeginTextureMode(cachedText);
-			ClearBackground(BLANK);
-			DrawTextEx(getFont(!FontFace), visibleText.c_str(), { 0,0 }, textParams.z, Spacing, { 255,255,255,255 });
-			EndTextureMode();
-			SetTextureWrap(cachedText.texture, TEXTURE_WRAP_CLAMP);
+		lastRenderMode = RenderMode;
+		if (RenderMode == TextRenderMode::GLYPHS) {
+			cachedText.Release();
+			layoutGlyphs(glyphs, getFont(!FontFace), visibleText.c_str(), textParams.z, Spacing);
+			return;
+		}
+		glyphs = {};
 
-			if (hadClip) BeginScissorMode(current.x, current.y, current.w, current.h);
+		if (Text.size()) cachedText.Reserve(this, newSize, TextTextureUpdateAspect);
+		if (cachedText.Begin()) {
+			DrawTextEx(getFont(!FontFace), visibleText.c_str(), cachedText.Origin(), textParams.z, Spacing, { 255,255,255,255 });
+			cachedText.End();
 		}
 	}
 public:
@@ -2445,6 +4912,7 @@ public:
 	int Spacing = defaultSpacing;
 	int MaxVisibleSymbols = -1;
 	bool MaxVisibleRight = false;
+	TextRenderMode RenderMode = defaultTextRenderMode; // TEXTURE for text drawn with heavy effects or reused a lot
 
 	const SUI_Text& GetText() const {
 		return Text;
@@ -2463,6 +4931,7 @@ public:
 	}
 
 	void Draw() override {
+		DrawList::OwnerScope drawOwner(this);
 		if (Visible) {
 			if (RealPos.x + RealSize.x + BorderThickness < 0
 				or RealPos.x - RealSize.x - BorderThickness > winWidth
@@ -2489,31 +4958,34 @@ public:
 			Text.restate();
 			FontFace.restate();
 
-			if (lastParams.z != textParams.z or (cachedText.id == 0 and Text.size()) or dirtyCondition or lastMaxVisible != MaxVisibleSymbols) {
+			if (lastParams.z != textParams.z or (needsTexture() and Text.size()) or dirtyCondition or lastMaxVisible != MaxVisibleSymbols or lastRenderMode != RenderMode) {
 				updateTexture();
 			} else {
 				if (std::fabsf(lastRealSize.x - RealSize.x) >= TextTextureUpdateAspect or std::fabsf(lastRealSize.y - RealSize.y) >= TextTextureUpdateAspect) {
 					lastRealSize = RealSize;
-					newSize = MeasureTextEx(getFont(!FontFace), visibleText.c_str(), textParams.z, Spacing);
-					textParams = getTextCFrame(visibleText.c_str(), getFont(!FontFace), { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
+					newSize = metrics.At(textParams.z, Spacing);
+					textParams = getTextCFrame(metrics, { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
 				}
 			}
 
 			if (textParams.z > 1) {
-				if (cachedText.id == 0) {
-					updateTexture();
+				Color tint = { TextColor.r, TextColor.g, TextColor.b, (unsigned char)(TextColor.a * (1 - TextTransparency)) };
+				if (RenderMode == TextRenderMode::GLYPHS) {
+					DrawList::Glyphs(getFont(!FontFace).texture, glyphs, { RealPos.x + textParams.x, RealPos.y + textParams.y }, tint);
+					return;
 				}
-				Rectangle sourceRec = { 0.0f, (float)(cachedText.texture.height - newSize.y), (float)newSize.x, -(float)newSize.y };
-				Rectangle destRec = { RealPos.x + textParams.x, RealPos.y + textParams.y, (float)newSize.x, (float)newSize.y };
-				SpecialVector2 origin = { 0, 0 };
 
-				DrawTexturePro(cachedText.texture, sourceRec, destRec, origin, 0, { TextColor.r, TextColor.g, TextColor.b, (unsigned char)(TextColor.a * (1 - TextTransparency)) });
+				if (needsTexture()) {
+					updateTexture();
+				}
+				cachedText.Draw({ 0, 0, newSize.x, newSize.y }, { RealPos.x + textParams.x, RealPos.y + textParams.y }, tint);
 			}
 		}
 	}
 	
 	TextLabel* Clone() const override {
 		TextLabel* i = new TextLabel(*this);
+		i->bindVectors();
 		i->Parent = nullptr;
 		i->Children.clear();
 
@@ -2521,8 +4993,7 @@ public:
 			c->Clone()->setParent(i);
 		}
 
-		i->cachedText.id = 0;
-		i->cachedText.texture.id = 0;
+		i->cachedText = {};
 		i->updateTexture();
 
 		return i;
@@ -2531,13 +5002,75 @@ public:
 	TextLabel(bool a) : Object2D(a) { Name = DefaultName; Class = DefaultClass; };
 	TextLabel(Instance* p) : Object2D(p) { Name = DefaultName; Class = DefaultClass; }
 	~TextLabel() {
-		if (cachedText.id != 0) {
-			UnloadRenderTexture(cachedText);
-		}
+		cachedText.Release();
 	}
 	TextLabel() = delete;
 };
 
+// Array with a gap at the last edit, inserting or erasing there moves nothing behind it. A Relative buffer holds
+// ascending values such as offsets: the ones behind the gap are kept as Total - value, so shifting all of them
+// after an edit is a change of Total. Moving the gap costs the distance it moves.
+template <typename T, bool Relative = false>
+class GapBuffer {
+	std::vector<T> data;
+	size_t gapStart = 0;
+	size_t gapEnd = 0;
+
+	void moveGap(size_t pos) {
+		while (gapStart > pos) {
+			T value = data[--gapStart];
+			data[--gapEnd] = Relative ? Total - value : value;
+		}
+		while (gapStart < pos) {
+			T value = data[gapEnd++];
+			data[gapStart++] = Relative ? Total - value : value;
+		}
+	}
+
+	void reserveGap(size_t count) {
+		if (gapEnd - gapStart >= count) return;
+		size_t tail = data.size() - gapEnd;
+		size_t capacity = std::max(data.size() * 2, size() + count + 16);
+		data.resize(capacity);
+		std::move_backward(data.begin() + gapEnd, data.begin() + gapEnd + tail, data.end());
+		gapEnd = capacity - tail;
+	}
+
+public:
+	T Total{}; // what values behind the gap are relative to
+
+	size_t size() const {
+		return data.size() - (gapEnd - gapStart);
+	}
+
+	T operator[](size_t index) const {
+		if (index < gapStart) return data[index];
+		T value = data[index + gapEnd - gapStart];
+		return Relative ? Total - value : value;
+	}
+
+	void replace(size_t from, size_t to, const T* values, size_t count, T shift = T{}) { // [from, to) becomes values, the rest moves by shift
+		moveGap(to);
+		gapStart = from;
+		if constexpr (Relative) Total += shift;
+		reserveGap(count);
+		std::copy(values, values + count, data.begin() + gapStart);
+		gapStart += count;
+	}
+
+	void assign(const T* values, size_t count, T total = T{}) {
+		data.assign(values, values + count);
+		gapStart = gapEnd = count;
+		Total = total;
+	}
+
+	void copyTo(T* out) const {
+		static_assert(!Relative, "values behind the gap are stored relative to Total");
+		out = std::copy(data.begin(), data.begin() + gapStart, out);
+		std::copy(data.begin() + gapEnd, data.end(), out);
+	}
+};
+
 struct KeyMapping {
 	KeyboardKey key;
 	const char* defaultEN;
@@ -2619,32 +5152,140 @@ class TextBox : public Object2D {
 
 	bool deleteText = false;
 
-	void updateCharOffsets() {
-		charOffsets.clear();
-		for (int i = 0; i < Text.size();) {
-			charOffsets.push_back(i);
-			unsigned char c = Text[i];
-			if (c < 0x80) i += 1;
-			else if ((c & 0xE0) == 0xC0) i += 2;
-			else if ((c & 0xF0) == 0xE0) i += 3;
-			else if ((c & 0xF8) == 0xF0) i += 4;
-			else i += 1;
-		}
-		charOffsets.push_back(Text.size());
-	}
-
-	std::vector<int> charOffsets;
 	Vector3 textParams{};
-	RenderTexture2D cachedText;
+	TextCache cachedText;
 	TextBox* lastFocused = nullptr;
 	SpecialVector2 newSize{};
 	SpecialVector2 lastRealSize{};
 	Vector3 lastParams = Vector3{};
 	char lastHideText = '\0';
-	SpecialVector2 lastNewSize{};
 	TextBoxType lastType = TextResizing;
 	int lastCursorIndex = -1;
 	float viewportPosition = 0;
+	TextMetrics shownMetrics() { // of Text, or the placeholder when empty
+		Font font = getFont(!FontFace);
+		if (Text.empty()) return MetricsCache::Get(font, !PlaceholderText);
+
+		syncText();
+		if (newlines or !font.glyphs or font.baseSize <= 0) return MetricsCache::Get(font, !Text);
+
+		TextMetrics m; // one line, its width is the last advance so the text is not read
+		m.Width = advances[advances.size() - 1];
+		m.Chars = (int)charOffsets.size() - 1;
+		m.Lines = 1;
+		m.BaseSize = font.baseSize;
+		return m;
+	}
+
+	struct TextBuffer : SUI_TextSource { // the bytes of Text, which copies them out only when it is read
+		GapBuffer<char> bytes;
+
+		size_t size() const override {
+			return bytes.size();
+		}
+
+		char at(size_t index) const override {
+			return bytes[index];
+		}
+
+		void copyTo(char* out) const override {
+			bytes.copyTo(out);
+		}
+	};
+
+	// Text while it is edited: the bytes, the byte offset of every codepoint with Text.size() last and the font
+	// units before every codepoint on one line, all with their gap at the last edit. editText changes them there
+	// and hands the bytes to Text, so typing moves only the gaps. Read again when Text is set from outside.
+	TextBuffer buffer;
+	GapBuffer<int, true> charOffsets;
+	GapBuffer<float, true> advances;
+	int newlines = 0; // in the buffer, the advances are only one line's width without them
+	unsigned long long bufferRevision = ~0ull;
+	const void* bufferFont = nullptr;
+
+	static float advanceOf(const Font& font, int codepoint) {
+		int index = GetGlyphIndex(font, codepoint);
+		return font.glyphs[index].advanceX > 0 ? font.glyphs[index].advanceX : font.recs[index].width + font.glyphs[index].offsetX;
+	}
+
+	void syncText() {
+		Font font = getFont(!FontFace);
+		if (bufferRevision == Text.Revision() and bufferFont == font.glyphs) return;
+		bufferRevision = Text.Revision();
+		bufferFont = font.glyphs;
+
+		std::vector<int> offsets;
+		std::vector<float> widths{ 0 };
+		newlines = 0;
+		for (int i = 0; i < (int)Text.size();) {
+			int bytes = 0;
+			int codepoint = GetCodepointNext(Text.c_str() + i, &bytes);
+			offsets.push_back(i);
+			widths.push_back(widths.back() + (font.glyphs ? advanceOf(font, codepoint) : 0));
+			newlines += codepoint == '\n';
+			i += bytes;
+		}
+		offsets.push_back((int)Text.size());
+
+		buffer.bytes.assign(Text.c_str(), Text.size());
+		charOffsets.assign(offsets.data(), offsets.size(), (int)Text.size());
+		advances.assign(widths.data(), widths.size(), widths.back());
+	}
+
+	void editText(int from, int to, const std::string& insert) { // replaces the codepoints [from, to) of Text
+		syncText();
+		int count = (int)charOffsets.size() - 1;
+		from = std::clamp(from, 0, count);
+		to = std::clamp(to, from, count);
+
+		Font font = getFont(!FontFace);
+		int byteFrom = charOffsets[from], byteTo = charOffsets[to];
+		if (byteFrom == byteTo and insert.empty()) return;
+
+		std::vector<int> offsets;
+		std::vector<float> widths;
+		float width = advances[from];
+		for (int i = 0; i < (int)insert.size();) {
+			int bytes = 0;
+			int codepoint = GetCodepointNext(insert.c_str() + i, &bytes);
+			i += bytes;
+			offsets.push_back(byteFrom + i);
+			widths.push_back(width += (font.glyphs ? advanceOf(font, codepoint) : 0));
+			newlines += codepoint == '\n';
+		}
+		for (int i = byteFrom; i < byteTo; i++) {
+			newlines -= buffer.bytes[i] == '\n';
+		}
+
+		buffer.bytes.replace(byteFrom, byteTo, insert.data(), insert.size());
+		charOffsets.replace(from + 1, to + 1, offsets.data(), offsets.size(), byteFrom + (int)insert.size() - byteTo);
+		advances.replace(from + 1, to + 1, widths.data(), widths.size(), width - advances[to]);
+		Text.edited(&buffer);
+		bufferRevision = Text.Revision();
+	}
+
+	float caretX(int index) { // x of the caret before the codepoint at index, HideText shows one symbol per byte
+		syncText();
+		index = std::clamp(index, 0, (int)advances.size() - 1);
+		float scale = textParams.z / std::max(1, getFont(!FontFace).baseSize);
+		if (HideText != '\0') {
+			int symbols = charOffsets[index];
+			return symbols ? symbols * advanceOf(getFont(!FontFace), (unsigned char)HideText) * scale + (symbols - 1) * Spacing : 0;
+		}
+		return index ? advances[index] * scale + (index - 1) * Spacing : 0;
+	}
+
+	int caretAt(float x) { // index whose caret is nearest to x
+		syncText();
+		int count = (int)advances.size() - 1;
+		int low = 0, high = count; // first index whose gap to the next caret lies right of x
+		while (low < high) {
+			int middle = (low + high) / 2;
+			if (x < (caretX(middle) + caretX(middle + 1)) / 2.0f) high = middle;
+			else low = middle + 1;
+		}
+		return low;
+	}
 
 	void updateTextParams() {
 		if (Type == Viewported) {
@@ -2652,14 +5293,12 @@ class TextBox : public Object2D {
 			textParams.x = 0;
 			textParams.z = RealSize.y;
 		} else {
-			if (Text != "") {
-				textParams = getTextCFrame(Text.c_str(), getFont(!FontFace), { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
-			} else {
-				textParams = getTextCFrame(PlaceholderText.c_str(), getFont(!FontFace), { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
-			}
+			textParams = getTextCFrame(shownMetrics(), { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, TextAnchor, TextSize, Spacing);
 		}
 	}
 	void updateTexture() {
+		SUI_PROFILE(Profiler::PHASE_TEXT);
+		SUI_COUNT_COST(this, TextRegens);
 		updateTextParams();
 		lastFocused = FocusedTextBox;
 		lastParams = textParams;
@@ -2667,52 +5306,28 @@ class TextBox : public Object2D {
 		lastHideText = HideText;
 		lastType = Type;
 
-		if (Text != "") {
-			newSize = MeasureTextEx(getFont(!FontFace), Text.c_str(), textParams.z, Spacing);
-		} else {
-			if (CursorIndex == -1 or FocusedTextBox != this) {
-				newSize = MeasureTextEx(getFont(!FontFace), PlaceholderText.c_str(), textParams.z, Spacing);
-			}
-		}
-
-		if (lastNewSize.x < newSize.x or lastNewSize.y < newSize.y) {
-			if (cachedText.id != 0) {
-				UnloadRenderTexture(cachedText);
-			}
-
-			cachedText = LoadRenderTexture(newSize.x * TextTextureUpdateAspect, newSize.y * TextTextureUpdateAspect);
-			lastNewSize = SpecialVector2{ newSize.x * TextTextureUpdateAspect, newSize.y * TextTextureUpdateAspect };
+		if (Text != "" or CursorIndex == -1 or FocusedTextBox != this) {
+			newSize = shownMetrics().At(textParams.z, Spacing);
 		}
 
-		bool hadClip = !clipStack.empty();
-		Clip current;
-		if (hadClip) current = clipStack.back();
-
-		if (hadClip) EndScissorMode();
-
-		BeginTextureMode(cachedText);
-		ClearBackground(BLANK);
+		cachedText.Reserve(this, newSize, TextTextureUpdateAspect);
+		if (!cachedText.Begin()) return;
+		Vector2 origin = cachedText.Origin();
 
 		if (Text != "") {
 			std::string t;
-			if (HideText == '\0') {
-				t = !Text;
-			} else {
-				for (int i = 0; i < Text.size(); i++) {
-					t += HideText;
-				}
+			if (HideText != '\0') {
+				t.assign(Text.size(), HideText);
 			}
 
-			DrawTextEx(getFont(!FontFace), t.c_str(), { 0,0 }, textParams.z, Spacing, { 255,255,255,255 });
+			DrawTextEx(getFont(!FontFace), HideText == '\0' ? Text.c_str() : t.c_str(), origin, textParams.z, Spacing, { 255,255,255,255 });
 		} else {
 			if (CursorIndex == -1 or FocusedTextBox != this) {
-				DrawTextEx(getFont(!FontFace), PlaceholderText.c_str(), {0,0}, textParams.z, Spacing, {255,255,255,255});
+				DrawTextEx(getFont(!FontFace), PlaceholderText.c_str(), origin, textParams.z, Spacing, {255,255,255,255});
 			}
 		}
 
-		EndTextureMode();
-		SetTextureWrap(cachedText.texture, TEXTURE_WRAP_CLAMP);
-		if (hadClip) BeginScissorMode(current.x, current.y, current.w, current.h);
+		cachedText.End();
 	}
 public:
 	Color CursorColor = { 0,0,0,255 };
@@ -2733,6 +5348,7 @@ public:
 	TextBoxType Type = TextResizing;
 
 	void Draw() override {
+		DrawList::OwnerScope drawOwner(this);
 		if (!Visible) return;
 		if (RealPos.x + RealSize.x + BorderThickness < 0
 			or RealPos.x - RealSize.x - BorderThickness > winWidth
@@ -2755,33 +5371,24 @@ public:
 
 		bool updateCondition1 = PlaceholderText.isChanged() or FontFace.isChanged();
 
-		if (updateCondition1 or lastType != Type or cachedText.id == 0 or lastHideText != HideText or lastParams.x != textParams.x or lastParams.y != textParams.y or lastParams.z != textParams.z or ((FocusedTextBox == this and lastFocused != this) or (lastFocused == this and FocusedTextBox != this))) {
+		if (updateCondition1 or lastType != Type or (!cachedText.Valid() and hasRenderer()) or lastHideText != HideText or lastParams.x != textParams.x or lastParams.y != textParams.y or lastParams.z != textParams.z or ((FocusedTextBox == this and lastFocused != this) or (lastFocused == this and FocusedTextBox != this))) {
 			updateTexture();
 		} else if (Text.isChanged()) {
 			updateTexture();
 		} else {
 			if (lastRealSize.x != RealSize.x or lastRealSize.y != RealSize.y) {
 				updateTextParams();
-				if (Text == "") {
-					newSize = MeasureTextEx(getFont(!FontFace), PlaceholderText.c_str(), textParams.z, Spacing);
-				}
-				else {
-					newSize = MeasureTextEx(getFont(!FontFace), Text.c_str(), textParams.z, Spacing);
-				}
+				newSize = shownMetrics().At(textParams.z, Spacing);
 			}
 		}
 
 		if (textParams.z > 1) {
-			if (cachedText.id == 0) {
+			if (!cachedText.Valid() and hasRenderer()) {
 				updateTexture();
 			}
 
 			SpecialVector2 sizeToDraw = (Type == Viewported) ? RealSize : newSize;
 
-			Rectangle sourceRec = { (Type == Viewported) ? viewportPosition : 0.0f, (cachedText.texture.height - sizeToDraw.y), sizeToDraw.x, -sizeToDraw.y };
-			Rectangle destRec = { RealPos.x + textParams.x, RealPos.y + textParams.y, sizeToDraw.x, sizeToDraw.y };
-			SpecialVector2 origin = { 0, 0 };
-
 			Color clr;
 			if (Text == "") {
 				clr = { PlaceholderTextColor.r, PlaceholderTextColor.g, PlaceholderTextColor.b, (unsigned char)(PlaceholderTextColor.a * (1 - TextTransparency)) };
@@ -2790,35 +5397,22 @@ public:
 				clr = { TextColor.r, TextColor.g, TextColor.b, (unsigned char)(TextColor.a * (1 - TextTransparency)) };
 			}
 
-			DrawTexturePro(cachedText.texture, sourceRec, destRec, origin, 0, clr);
+			cachedText.Draw({ (Type == Viewported) ? viewportPosition : 0.0f, 0, sizeToDraw.x, sizeToDraw.y }, { RealPos.x + textParams.x, RealPos.y + textParams.y }, clr);
 		}
 
 		if (Text == "") {
 			if (CursorVisible and FocusedTextBox == this) {
 				if (textParams.z > 3) {
-					float sizeY = MeasureTextEx(getFont(!FontFace), " ", textParams.z, Spacing).y;
-					DrawLineEx({ RealPos.x + getTextOffset(TextAnchor).x * RealSize.x - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + 2 }, { RealPos.x + getTextOffset(TextAnchor).x * RealSize.x - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + sizeY - 4 }, CursorSize, CursorColor);
+					float sizeY = textParams.z; // height of one line
+					DrawList::Line({ RealPos.x + getTextOffset(TextAnchor).x * RealSize.x - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + 2 }, { RealPos.x + getTextOffset(TextAnchor).x * RealSize.x - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + sizeY - 4 }, CursorSize, CursorColor);
 				}
 			}
 		}
 
 		if (CursorIndex >= 0 and CursorVisible and Text != "" and textParams.z > 3) {
-			int bytePos = (CursorIndex < (int)charOffsets.size()) ? charOffsets[CursorIndex] : Text.size();
-			std::string textBeforeCursor = Text.substr(0, bytePos);
-			if (HideText != '\0') {
-				textBeforeCursor = "";
-				for (int i = 0; i < bytePos; i++) {
-					textBeforeCursor += HideText;
-				}
-			}
-
-			SpecialVector2 size = MeasureTextEx(getFont(!FontFace), textBeforeCursor.c_str(), textParams.z, Spacing);
+			SpecialVector2 size = { caretX(CursorIndex), textParams.z };
 
-			if (size.x == 0 and size.y == 0) {
-				size.y = MeasureTextEx(getFont(!FontFace), "a", textParams.z, Spacing).y;
-			}
-
-			DrawLineEx({ RealPos.x + textParams.x + size.x + 2 - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + 2 }, { RealPos.x + textParams.x + size.x + 2 - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + size.y - 4 }, CursorSize, CursorColor);
+			DrawList::Line({ RealPos.x + textParams.x + size.x + 2 - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + 2 }, { RealPos.x + textParams.x + size.x + 2 - ((Type == Viewported) ? viewportPosition : 0), RealPos.y + textParams.y + size.y - 4 }, CursorSize, CursorColor);
 		}
 	}
 
@@ -2829,18 +5423,18 @@ public:
 			Text = "";
 			CursorIndex = 0;
 			deleteText = false;
-			updateCharOffsets();
 		}
 
 		CursorTime += dt;
 		if (CursorTime >= CursorCooldown) { CursorVisible = !CursorVisible; CursorTime = 0.0f; }
+		if (FocusedTextBox == this) requestFrameIn(CursorCooldown - CursorTime);
 
 		if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
 			if (pointInObject(mousePosition) and FocusedTextBox != this and higherObject == this and ClearOnClick) {
 				Text = "";
 			}
 			if (higherObject != this and higherObject) {
-				if (higherObject->Class == TEXTBOX) {
+				if (HasTrait(higherObject->Class, TRAIT_INPUT)) {
 					FocusedTextBox = static_cast<TextBox*>(higherObject);
 				}
 				else {
@@ -2855,49 +5449,17 @@ public:
 				CursorVisible = true;
 				FocusedTextBox = this;
 
-				std::string text = "";
-				if (HideText != '\0') {
-					for (int i = 0; i < Text.size(); i++) {
-						text += HideText;
-					}
-				}
-				else {
-					text = !Text;
-				}
-
 				updateTextParams();
-				std::string textBeforeCursor = "";
-				if (HideText != '\0') {
-					for (int i = 0; i < Text.size(); i++) {
-						textBeforeCursor += HideText;
-					}
-				}
-				else {
-					textBeforeCursor = !Text;
-				}
 
 				float textStartX = RealPos.x + textParams.x;
 				float clickX = mousePosition.x - textStartX + ((Type == Viewported) ? viewportPosition : 0.0f);
 
-				CursorIndex = 0;
-				if (!text.empty()) {
-					for (int i = 1; i < charOffsets.size(); i++) {
-						float widthPrev = MeasureTextEx(getFont(!FontFace), text.substr(0, charOffsets[i - 1]).c_str(), textParams.z, Spacing).x;
-						float widthCurr = MeasureTextEx(getFont(!FontFace), text.substr(0, charOffsets[i]).c_str(), textParams.z, Spacing).x;
-						if (clickX < (widthPrev + widthCurr) / 2.0f) {
-							CursorIndex = i - 1;
-							break;
-						}
-						CursorIndex = i;
-					}
-				}
-				else {
-					CursorIndex = 0;
-				}
+				CursorIndex = caretAt(clickX);
 			}
 		}
 
 		// KEYBOARD INPUT
+		syncText(); // Text may have been set since the last frame
 
 		if (FocusedTextBox == this and Visible) {
 			if (maxSymbols >= charOffsets.size()) {
@@ -2926,11 +5488,8 @@ public:
 							}
 							if (!allowed) continue;
 						}
-						updateCharOffsets();
-						int bytePos = (CursorIndex < (int)charOffsets.size()) ? charOffsets[CursorIndex] : Text.size();
-						Text = Text.substr(0, bytePos) + std::string(keyValue) + Text.substr(bytePos);
+						editText(CursorIndex, CursorIndex, keyValue);
 						CursorIndex += 1;
-						updateCharOffsets();
 						CursorVisible = true; CursorTime = 0.0f;
 					}
 				}
@@ -2978,18 +5537,14 @@ public:
 							}
 						}
 
-						Text = Text.substr(0, charOffsets[start]) + Text.substr(charOffsets[CursorIndex]);
+						editText(start, CursorIndex, "");
 						CursorIndex = start;
-
-						updateCharOffsets();
 					}
 				}
 				else {
 					if (CursorIndex > 0) {
-						Text = Text.substr(0, charOffsets[CursorIndex - 1]) + Text.substr(charOffsets[CursorIndex]);
+						editText(CursorIndex - 1, CursorIndex, "");
 						CursorIndex--;
-
-						updateCharOffsets();
 					}
 				}
 
@@ -2999,9 +5554,7 @@ public:
 
 			if (IsKeyPressed(KEY_DELETE)) {
 				if (CursorIndex < (int)charOffsets.size() - 1) {
-					Text = Text.substr(0, charOffsets[CursorIndex]) + Text.substr(charOffsets[CursorIndex + 1]);
-
-					updateCharOffsets();
+					editText(CursorIndex, CursorIndex + 1, "");
 				}
 
 				CursorVisible = true;
@@ -3077,12 +5630,12 @@ public:
 	void Update() override {
 		if (lastUpdateFrame == framesSinceStart) return;
 		lastUpdateFrame = framesSinceStart;
+		SUI_PROFILE_OBJECT(this);
 
 		if (!Visible) { CursorIndex = -1; CursorVisible = false; Text = ""; return; }
 		if (!(FocusedTextBox == this)) { CursorIndex = -1; CursorVisible = false; deleteText = true; }
 
-		getRealObject2Dsize();
-		getRealObject2Dposition();
+		updateLayout();
 
 		inputHandler();
 
@@ -3102,10 +5655,7 @@ public:
 					viewportPosition = 0.0f;
 				}
 				else {
-					std::string textBeforeCursor = Text.substr(0, charOffsets[CursorIndex]);
-					SpecialVector2 textSize = MeasureTextEx(getFont(!FontFace), textBeforeCursor.c_str(), textParams.z, Spacing);
-
-					float currentX = textSize.x;
+					float currentX = caretX(CursorIndex);
 
 					if (currentX - viewportPosition >= RealSize.x) {
 						viewportPosition = currentX - RealSize.x;
@@ -3133,13 +5683,11 @@ public:
 	};
 
 	~TextBox() {
-		if (cachedText.id != 0) {
-			UnloadRenderTexture(cachedText);
-		}
+		cachedText.Release();
 	}
 
 	size_t size() {
-		updateCharOffsets();
+		syncText();
 		return charOffsets.size();
 	}
 
@@ -3157,13 +5705,11 @@ public:
 
 		if (offsets.size() > maxSymbols) {
 			Text = t.substr(0, offsets[maxSymbols]);
-			updateCharOffsets();
 			CursorIndex = maxSymbols;
 			return;
 		}
 
 		Text = t;
-		updateCharOffsets();
 		CursorIndex = t.size();
 	}
 
@@ -3173,14 +5719,14 @@ public:
 
 	TextBox* Clone() const override {
 		TextBox* i = new TextBox(*this);
+		i->bindVectors();
 		i->Parent = nullptr;
 		i->Children.clear();
 		for (Instance* c : Children) {
 			c->Clone()->setParent(i);
 		}
 
-		i->cachedText.id = 0;
-		i->cachedText.texture.id = 0;
+		i->cachedText = {};
 		i->updateTexture();
 
 		return i;
@@ -3231,19 +5777,24 @@ public:
 	bool RoundImage = false;
 	float Rotation = 0;
 	SpecialVector2 Origin = { 0, 0 };
+	Color PlaceholderColor = { 128, 128, 128, 60 }; // drawn while the image is decoded or uploaded
 
 	void setImage(const std::string& name = "") {
 		if (isMemoryLoadedTex) {
 			isMemoryLoadedTex = false;
+			DrawList::ReleaseTexture(tex.id);
 			UnloadTexture(tex);
 		}
 
+		ImageCache::release(currentPair, this);
 		auto pair = getImage(name);
 		tex = pair.second;
 		currentPair = name;
+		ImageCache::acquire(name, this); // set again when the texture is uploaded or evicted
 	}
 
 	void Draw() override {
+		DrawList::OwnerScope drawOwner(this);
 		if (!Visible) return;
 		Object2D::Draw();
 
@@ -3255,6 +5806,8 @@ public:
 		}
 
 		if (tex.id) {
+			if (currentPair != "") ImageCache::touch(currentPair);
+			if (currentPair != "" and (tex.width < RealSize.x or tex.height < RealSize.y)) ImageCache::grow(currentPair, RealSize.x, RealSize.y);
 			Rectangle destRec = { RealPos.x + Origin.x, RealPos.y + Origin.y, RealSize.x, RealSize.y };
 			Rectangle srcRec = { 0, 0, tex.width, tex.height };
 
@@ -3287,39 +5840,14 @@ public:
 			}
 
 			if (Roundness and RoundImage) {
-				static bool roundShaderLoaded = false;
-				static Shader shader;
-				static float lastRoundness = 0;
-				static Rectangle lastObjectData = {0,0,0,0};
-				static Rectangle lastImageData = {0,0,0,0};
-				if (!roundShaderLoaded) {
-					shader = getShader("TextureRoundness");
-					roundShaderLoaded = true;
-				}
-
-				if (Roundness != lastRoundness) {
-					lastRoundness = Roundness;
-					SetShaderValue(shader, GetShaderLocation(shader, "roundness"), &Roundness, SHADER_UNIFORM_FLOAT);
-				}
-
-				if (destRec.width != lastObjectData.width or destRec.height != lastObjectData.height) {
-					lastObjectData = destRec;
-					SetShaderValue(shader, GetShaderLocation(shader, "objectData"), &destRec, SHADER_UNIFORM_VEC4);
-				}
-				if (srcRec.x != lastImageData.x or srcRec.y != lastImageData.y or
-					srcRec.width != lastImageData.width or srcRec.height != lastImageData.height) {
-					lastImageData = srcRec;
-					SetShaderValue(shader, GetShaderLocation(shader, "imageData"), &srcRec, SHADER_UNIFORM_VEC4);
-				}
-
-				BeginShaderMode(shader);
-				DrawTexturePro(tex, srcRec, destRec, Origin, Rotation, { ImageColor.r, ImageColor.g, ImageColor.b, (unsigned char)(ImageColor.a * (1 - ImageTransparency)) });
-				EndShaderMode();
+				DrawList::TextureProRounded(tex, srcRec, destRec, Origin, Rotation, { ImageColor.r, ImageColor.g, ImageColor.b, (unsigned char)(ImageColor.a * (1 - ImageTransparency)) }, Roundness);
 			} else {
-				DrawTexturePro(tex, srcRec, destRec, Origin, Rotation, { ImageColor.r, ImageColor.g, ImageColor.b, (unsigned char)(ImageColor.a * (1 - ImageTransparency)) });
+				DrawList::TexturePro(tex, srcRec, destRec, Origin, Rotation, { ImageColor.r, ImageColor.g, ImageColor.b, (unsigned char)(ImageColor.a * (1 - ImageTransparency)) });
 			}
-		} else {
-			setImage(currentPair);
+		} else if (currentPair != "") {
+			ImageCache::reload(currentPair, RealSize.x, RealSize.y);
+			ImageLoader::want(currentPair, RealSize.x * RealSize.y);
+			if (PlaceholderColor.a) DrawList::RectangleRounded({ RealPos.x, RealPos.y, RealSize.x, RealSize.y }, RoundImage ? Roundness : 0, Segments, PlaceholderColor);
 		}
 	}
 
@@ -3330,18 +5858,21 @@ public:
 			std::cout << "UpdateFromMemory FAILED" << std::endl;
 		}
 
-		if (tex.id != 0 and isMemoryLoadedTex) UnloadTexture(tex);
+		if (tex.id != 0 and isMemoryLoadedTex) {
+			DrawList::ReleaseTexture(tex.id);
+			UnloadTexture(tex);
+		}
 	
 		isMemoryLoadedTex = true;
-		tex = LoadTextureFromImage(image);
-		GenTextureMipmaps(&tex);
-		SetTextureFilter(tex, TEXTURE_FILTER_TRILINEAR);
-		SetTextureWrap(tex, TEXTURE_WRAP_CLAMP);
+		tex = uploadTexture(image);
+		if (tex.id) SetTextureWrap(tex, TEXTURE_WRAP_CLAMP);
+		ImageCache::release(currentPair, this);
 		currentPair = "";
 	}
 
 	ImageLabel* Clone() const override {
 		ImageLabel* i = new ImageLabel(*this);
+		i->bindVectors();
 		i->setParent(nullptr);
 		i->Children.clear();
 		for (Instance* c : Children) {
@@ -3352,6 +5883,7 @@ public:
 			i->isMemoryLoadedTex = false;
 			i->tex.id = 0;
 		}
+		ImageCache::acquire(i->currentPair, i);
 
 		return i;
 	}
@@ -3362,10 +5894,200 @@ public:
 	ImageLabel() = delete;
 
 	~ImageLabel() {
-		if (tex.id != 0 and isMemoryLoadedTex) UnloadTexture(tex);
+		ImageCache::release(currentPair, this);
+		if (tex.id != 0 and isMemoryLoadedTex) {
+			DrawList::ReleaseTexture(tex.id);
+			UnloadTexture(tex);
+		}
 	}
 };
 
+namespace ImageLoader {
+	inline int fitTier(const std::string& name) { // smallest tier covering the largest label using the image
+		auto it = ImageCache::entries.find(name);
+		if (it == ImageCache::entries.end()) return 0;
+		int tier = -1;
+		for (ImageLabel* label : it->second.Labels) {
+			if (label->RealSize.x <= 0 or label->RealSize.y <= 0) continue;
+			int fit = ImageCache::tierFor(label->RealSize.x, label->RealSize.y, it->second);
+			tier = tier < 0 ? fit : std::min(tier, fit);
+		}
+		return std::max(0, tier);
+	}
+
+	inline bool step(UploadJob& job) { // one strip or the mipmaps, true when the texture is complete
+		if (job.Tier < 0) {
+			job.Tier = std::clamp(fitTier(job.Name), job.FirstTier, job.FirstTier + (int)job.Tiers.size() - 1);
+			job.Img = job.Tiers[job.Tier - job.FirstTier];
+		}
+
+		const Image& img = job.Img;
+		if (!hasRenderer()) return true;
+		if (img.mipmaps > 1 or img.format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) { // not split into rows
+			job.Tex = uploadTexture(img);
+			if (job.Tex.id) SetTextureWrap(job.Tex, TEXTURE_WRAP_CLAMP);
+			return true;
+		}
+
+		if (!job.Tex.id) {
+			job.Tex = { rlLoadTexture(nullptr, img.width, img.height, img.format, 1), img.width, img.height, 1, img.format };
+			if (!job.Tex.id) return true;
+			SetTextureWrap(job.Tex, TEXTURE_WRAP_CLAMP);
+		}
+
+		if (job.Rows < img.height) {
+			int rowBytes = std::max(1, GetPixelDataSize(img.width, 1, img.format));
+			int rows = std::clamp(StripBytes / rowBytes, 1, img.height - job.Rows);
+			UpdateTextureRec(job.Tex, { 0, (float)job.Rows, (float)img.width, (float)rows }, (const unsigned char*)img.data + (size_t)job.Rows * rowBytes);
+			job.Rows += rows;
+			return false;
+		}
+
+		GenTextureMipmaps(&job.Tex);
+		SetTextureFilter(job.Tex, TEXTURE_FILTER_TRILINEAR);
+		return true;
+	}
+
+	inline void finish(UploadJob& job) { // moves the image to loadedImages and sets the labels using it
+		ImageCache::Entry& entry = ImageCache::entries[job.Name];
+		for (Image& img : job.Tiers) {
+			if (img.data != job.Img.data) UnloadImage(img);
+		}
+
+		auto previous = loadedImages.find(job.Name);
+		if (previous != loadedImages.end()) { // a smaller tier
+			UnloadImage(previous->second.first);
+			DrawList::ReleaseTexture(previous->second.second.id);
+			UnloadTexture(previous->second.second);
+			loadedImages.erase(previous);
+			ImageCache::Used -= entry.Bytes;
+			entry.Bytes = 0;
+		}
+
+		entry.Loading = false;
+		entry.LastUsed = ImageCache::Frame;
+		entry.Tier = job.Tier;
+		if (job.Tex.id) {
+			entry.Bytes = std::max(1, GetPixelDataSize(job.Tex.width, job.Tex.height, job.Tex.format));
+			if (job.Tex.mipmaps > 1) entry.Bytes += entry.Bytes / 3;
+			ImageCache::Used += entry.Bytes;
+			if (!ImageCache::KeepImages) {
+				UnloadImage(job.Img);
+				job.Img = Image{};
+			}
+		}
+
+		loadedImages.insert({ job.Name, { job.Img, job.Tex } });
+		pendingImages.erase(job.Name);
+
+		std::vector<ImageLabel*> labels = entry.Labels;
+		for (ImageLabel* label : labels) label->setImage(job.Name);
+	}
+
+	inline void Upload() { // upload steps until the budget is spent, images waited for by the largest labels on screen first
+		while (Decoded* result = decoded.pop()) {
+			bool fresh = current(result->Name, result->Id);
+			auto entry = ImageCache::entries.find(result->Name);
+			bool upgrade = entry != ImageCache::entries.end() and entry->second.Loading;
+			if (result->Tiers.size() and fresh and pendingImages.find(result->Name) == pendingImages.end() and (upgrade or loadedImages.find(result->Name) == loadedImages.end())) {
+				pendingImages.insert({ result->Name, result->Tiers[0] });
+				uploads.push_back({ result->Name, std::move(result->Tiers), result->Tier });
+				ImageCache::Entry& e = ImageCache::entries[result->Name];
+				e.Path = result->Path;
+				e.Width = result->Width;
+				e.Height = result->Height;
+			} else {
+				for (Image& img : result->Tiers) UnloadImage(img);
+				if (fresh and entry != ImageCache::entries.end()) entry->second.Loading = false;
+			}
+			delete result;
+		}
+
+		std::erase_if(uploads, [](UploadJob& job) { // unloaded meanwhile, unloadImage freed the first tier
+			auto it = pendingImages.find(job.Name);
+			if (it != pendingImages.end() and it->second.data == job.Tiers[0].data) return false;
+			for (size_t i = 1; i < job.Tiers.size(); i++) UnloadImage(job.Tiers[i]);
+			if (job.Tex.id) UnloadTexture(job.Tex);
+			return true;
+		});
+
+		auto area = [](const UploadJob& job) {
+			auto it = wanted.find(job.Name);
+			return it == wanted.end() ? 0.0f : it->second;
+		};
+		std::stable_sort(uploads.begin(), uploads.end(), [&area](const UploadJob& a, const UploadJob& b) { return area(a) > area(b); });
+		wanted.clear();
+
+		auto start = std::chrono::steady_clock::now();
+		for (int steps = 0; uploads.size(); steps++) {
+			if (steps and std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > UploadBudget) {
+				requestFrameIn(0);
+				break;
+			}
+
+			if (step(uploads.front())) {
+				finish(uploads.front());
+				uploads.erase(uploads.begin());
+			}
+		}
+	}
+}
+
+namespace ImageCache {
+	inline void evict(const std::string& name) { // frees the texture, labels using it show their placeholder until it is reloaded
+		auto it = loadedImages.find(name);
+		if (it == loadedImages.end()) return;
+		UnloadImage(it->second.first);
+		DrawList::ReleaseTexture(it->second.second.id);
+		UnloadTexture(it->second.second);
+		loadedImages.erase(it);
+
+		Entry& entry = entries[name];
+		Used -= entry.Bytes;
+		entry.Bytes = 0;
+		std::vector<ImageLabel*> labels = entry.Labels;
+		for (ImageLabel* label : labels) label->setImage(name);
+	}
+
+	inline void Maintain() { // evicts textures not drawn lately, least recently drawn first, until Used fits the budget
+		Frame++;
+		if (Used <= VRAMBudget) return;
+
+		std::vector<std::pair<size_t, const std::string*>> unused;
+		for (auto& [name, entry] : entries) {
+			if (entry.Bytes and entry.LastUsed + EvictAfterFrames < Frame) unused.push_back({ entry.LastUsed, &name });
+		}
+		std::sort(unused.begin(), unused.end());
+
+		for (auto& [lastUsed, name] : unused) {
+			if (Used <= VRAMBudget) break;
+			evict(*name);
+			Evictions++;
+		}
+	}
+}
+
+inline void unloadImage(const std::string& name) {
+	{
+		std::lock_guard<std::mutex> lock(ImageLoader::requestsMtx);
+		ImageLoader::requested.erase(name);
+	}
+
+	auto entry = ImageCache::entries.find(name);
+	if (entry != ImageCache::entries.end()) {
+		ImageCache::evict(name);
+		entry->second.Path.clear();
+		entry->second.Loading = false;
+		if (entry->second.Labels.empty()) ImageCache::entries.erase(entry);
+	}
+
+	auto it1 = pendingImages.find(name);
+	if (it1 != pendingImages.end()) {
+		UnloadImage(it1->second);
+		pendingImages.erase(it1);
+	}
+}
+
 class TextureLabel : public Object2D {
 	constexpr static const char* DefaultName = "TextureLabel";
 	constexpr static InstanceType DefaultClass = TEXTURELABEL;
@@ -3378,10 +6100,13 @@ class TextureLabel : public Object2D {
 	void SetSize(int w, int h) {
 		if (texture.id == 0 or texture.width != w or texture.height != h or !owner) {
 			owner = true;
-			if (texture.id != 0) UnloadTexture(texture);
+			if (texture.id != 0) {
+				DrawList::ReleaseTexture(texture.id);
+				UnloadTexture(texture);
+			}
 
 			Image img = GenImageColor(w, h, BLANK);
-			texture = LoadTextureFromImage(img);
+			texture = uploadTexture(img, false);
 			UnloadImage(img);
 		}
 	}
@@ -3391,6 +6116,7 @@ public:
 	SpecialVector2 Origin = { 0, 0 };
 
 	void Draw() override {
+		DrawList::OwnerScope drawOwner(this);
 		if (Visible) {
 			Object2D::Draw();
 
@@ -3398,12 +6124,13 @@ public:
 				imageLoadedWhileNotReady = false;
 
 				if (img.data != nullptr) {
-					if (texture.id != 0 and owner) UnloadTexture(texture);
+					if (texture.id != 0 and owner) {
+						DrawList::ReleaseTexture(texture.id);
+						UnloadTexture(texture);
+					}
 
 					owner = true;
-					texture = LoadTextureFromImage(img);
-					GenTextureMipmaps(&texture);
-					SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+					texture = uploadTexture(img);
 					UnloadImage(img);
 				}
 			}
@@ -3419,7 +6146,7 @@ public:
 				return;
 			}
 
-			DrawTexturePro(texture, { 0,0,(float)texture.width,(float)texture.height }, { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, Origin, Rotation, TextureColor);
+			DrawList::TexturePro(texture, { 0,0,(float)texture.width,(float)texture.height }, { RealPos.x, RealPos.y, RealSize.x, RealSize.y }, Origin, Rotation, TextureColor);
 		}
 	}
 
@@ -3433,15 +6160,16 @@ public:
 		img = LoadImageFromMemory(type.c_str(), data.data(), data.size());
 
 		if (img.data == nullptr) return;
-		if (texture.id != 0 and owner) UnloadTexture(texture);
+		if (texture.id != 0 and owner) {
+			DrawList::ReleaseTexture(texture.id);
+			UnloadTexture(texture);
+		}
 
 		if (IsWindowReady()) {
 			imageLoadedWhileNotReady = false;
 
 			owner = true;
-			texture = LoadTextureFromImage(img);
-			GenTextureMipmaps(&texture);
-			SetTextureFilter(texture, TEXTURE_FILTER_TRILINEAR);
+			texture = uploadTexture(img);
 			UnloadImage(img);
 		}
 		else {
@@ -3451,12 +6179,14 @@ public:
 
 	void UpdateData(std::vector<char>& data, int w, int h) {
 		SetSize(w, h);
-		UpdateTexture(texture, data.data());
+		if (texture.id) UpdateTexture(texture, data.data());
+		DrawList::TextureChanged(texture.id);
 		owner = true;
 	}
 
 	TextureLabel* Clone() const override {
 		TextureLabel* i = new TextureLabel(*this);
+		i->bindVectors();
 		i->Parent = nullptr;
 		i->Children.clear();
 		for (Instance* c : Children) {
@@ -3474,7 +6204,10 @@ public:
 	TextureLabel() = delete;
 
 	~TextureLabel() {
-		if (texture.id != 0 and owner) UnloadTexture(texture);
+		if (texture.id != 0 and owner) {
+			DrawList::ReleaseTexture(texture.id);
+			UnloadTexture(texture);
+		}
 	}
 };
 
@@ -3508,6 +6241,7 @@ inline void Instance::AddEvent(EventType t, InstanceCallback f, MouseButtonType
 }
 
 inline void Object2D::eventHandler() {
+	SUI_PROFILE_IF(Profiler::PHASE_EVENTS, !events.empty());
 	bool mouseOnObject = pointInObject(mousePosition);
 	bool hasStartHold1 = false;
 	bool hasStartHold2 = false;
@@ -3520,6 +6254,7 @@ inline void Object2D::eventHandler() {
 	for (const auto& [type, func, mouse] : events) {
 		switch (type) {
 			case TICK: {
+				tickedInFrame = true;
 				func(this);
 				break;
 			} case MOUSE_ENTER: {
@@ -3608,12 +6343,9 @@ inline void Object2D::eventHandler() {
 				}
 				break;
 			} case TEXT_CHANGED: {
-				if (Class == TEXTLABEL) {
-					if (static_cast<TextLabel*>(this)->Text.isChanged()) {
-						func(this);
-					}
-				} else if (Class == TEXTBOX) {
-					if (static_cast<TextBox*>(this)->Text.isChanged()) {
+				if (HasTrait(Class, TRAIT_TEXT)) {
+					const SUI_Text& text = HasTrait(Class, TRAIT_INPUT) ? static_cast<TextBox*>(this)->Text : static_cast<TextLabel*>(this)->Text;
+					if (text.isChanged()) {
 						func(this);
 					}
 				}
@@ -3710,10 +6442,34 @@ inline std::vector<unsigned char> PngBytesToJpgBytes(const std::string& path, in
 }
 
 inline void DrawFrame(Instance* StartInstance) {
-	BeginDrawing();
-	ClearBackground({ 255,255,255,255 });
-	StartInstance->Update();
-	EndDrawing();
+	static int layoutWidth = 0, layoutHeight = 0;
+	if (layoutWidth != winWidth or layoutHeight != winHeight) {
+		layoutWidth = winWidth;
+		layoutHeight = winHeight;
+		layoutEpoch++;
+	}
+	{
+		SUI_PROFILE(Profiler::PHASE_LAYOUT);
+		LayoutStore::Solve(StartInstance);
+	}
+
+	{
+		SUI_PROFILE(Profiler::PHASE_DRAW);
+		if (hasRenderer()) {
+			BeginDrawing();
+			ClearBackground(DrawList::Background);
+		}
+		ImageLoader::Upload();
+		ImageCache::Maintain();
+		TextAtlas::Maintain();
+		DrawList::Begin();
+		StartInstance->Update();
+	}
+	{
+		SUI_PROFILE(Profiler::PHASE_PRESENT);
+		DrawList::Flush();
+		if (hasRenderer()) EndDrawing();
+	}
 }
 
 inline void toggleFPS(Instance* s, Color textColor = { 0,0,0,255 }) {
@@ -3785,6 +6541,138 @@ inline namespace debug {
 	Object2D* treeFrame = nullptr;
 	Instance* currentInstance = nullptr;
 
+#if SUI_PROFILER
+	struct SubtreeCost { // counters of the current frame summed over an object and its descendants
+		int Descendants = 0;
+		int Drawn = 0;
+		int Culled = 0; // 2D objects which were not drawn
+		int TextRegens = 0;
+		int Callbacks = 0;
+		double UpdateTime = 0;
+	};
+
+	inline void addCost(Instance* obj, SubtreeCost& total) {
+		const Instance::Cost& c = obj->cost;
+		bool current = c.Frame == framesSinceStart;
+		if (current) {
+			total.Drawn += c.Drawn;
+			total.TextRegens += c.TextRegens;
+			total.Callbacks += c.Callbacks;
+		}
+		if (HasTrait(obj->Class, TRAIT_DRAWS) and !(current and c.Drawn)) total.Culled++;
+
+		for (Instance* child : obj->Children) {
+			total.Descendants++;
+			addCost(child, total);
+		}
+	}
+
+	inline SubtreeCost subtreeCost(Instance* obj) {
+		SubtreeCost total;
+		addCost(obj, total);
+		if (obj->cost.Frame == framesSinceStart) total.UpdateTime = obj->cost.UpdateTime; // Update of obj includes its children
+		return total;
+	}
+
+	enum CostSort { SORT_ORDER, SORT_DESCENDANTS, SORT_DRAWN, SORT_TEXT, SORT_CALLBACKS, SORT_TIME, SORT_COUNT };
+	inline const char* CostSortNames[SORT_COUNT] = { "order", "descendants", "drawn", "text", "callbacks", "time" };
+	inline int costSort = SORT_ORDER;
+
+	struct HierarchyRow {
+		Instance* Obj;
+		TextLabel* Name;
+		TextLabel* Stats;
+		SubtreeCost Cost{};
+	};
+	inline std::vector<HierarchyRow> hierarchyRows;
+
+	inline double sortKey(const SubtreeCost& c) {
+		switch (costSort) {
+			case SORT_DESCENDANTS: return c.Descendants;
+			case SORT_DRAWN: return c.Drawn;
+			case SORT_TEXT: return c.TextRegens;
+			case SORT_CALLBACKS: return c.Callbacks;
+			case SORT_TIME: return c.UpdateTime;
+			default: return 0;
+		}
+	}
+
+	inline void refreshHierarchyCosts() {
+		if (!currentInstance) return;
+
+		std::vector<Instance*> alive = currentInstance->Children; // rows of deleted objects are not walked
+		std::sort(alive.begin(), alive.end());
+
+		for (HierarchyRow& row : hierarchyRows) {
+			if (!row.Obj) continue;
+			if (!std::binary_search(alive.begin(), alive.end(), row.Obj)) {
+				row.Obj = nullptr;
+				row.Cost = SubtreeCost{};
+				row.Stats->SetText("removed");
+				continue;
+			}
+
+			row.Cost = subtreeCost(row.Obj);
+			std::ostringstream text;
+			text.precision(2);
+			text << std::fixed << row.Cost.Descendants << " desc  " << row.Cost.Drawn << "/" << row.Cost.Culled << " drawn/culled  "
+				<< row.Cost.TextRegens << " text  " << row.Cost.Callbacks << " cb  " << row.Cost.UpdateTime * 1000 << " ms";
+			row.Stats->SetText(text.str());
+		}
+
+		std::vector<int> order;
+		for (int i = 0; i < (int)hierarchyRows.size(); i++) order.push_back(i);
+		if (costSort != SORT_ORDER) {
+			std::stable_sort(order.begin(), order.end(), [](int a, int b) { return sortKey(hierarchyRows[a].Cost) > sortKey(hierarchyRows[b].Cost); });
+		}
+
+		for (int i = 0; i < (int)order.size(); i++) {
+			HierarchyRow& row = hierarchyRows[order[i]];
+			row.Name->Position = SpecialVector2{ 0, i * 0.05f };
+			row.Stats->Position = SpecialVector2{ 0.45, i * 0.05f };
+		}
+	}
+#endif
+
+	class ProfilerGraph : public Object2D { // last frames as bars stacked by phase, white is time outside of phases
+	public:
+		ProfilerGraph(Instance* p) : Object2D(p) {}
+
+		void Draw() override {
+			DrawList::OwnerScope drawOwner(this);
+			if (!Visible) return;
+			Object2D::Draw();
+
+			double top = 1.0 / 30;
+			for (int age = 0; age < Profiler::HISTORY; age++) top = std::max(top, Profiler::Frame(age).Total);
+
+			float barWidth = RealSize.x / Profiler::HISTORY;
+			float scale = RealSize.y / top;
+			for (int age = 0; age < Profiler::HISTORY; age++) {
+				const Profiler::FrameRecord& f = Profiler::Frame(age);
+				float x = RealPos.x + RealSize.x - (age + 1) * barWidth;
+				float y = RealPos.y + RealSize.y;
+				double attributed = 0;
+
+				for (int p = 0; p < Profiler::PHASE_COUNT; p++) {
+					float h = f.Phases[p] * scale;
+					attributed += f.Phases[p];
+					if (h < 0.5f) continue;
+					y -= h;
+					DrawList::RectangleRounded({ x, y, barWidth, h }, 0, 0, Profiler::PhaseColors[p]);
+				}
+
+				float rest = (f.Total - attributed) * scale;
+				if (rest >= 0.5f) DrawList::RectangleRounded({ x, y - rest, barWidth, rest }, 0, 0, { 255,255,255,120 });
+			}
+
+			for (double fps : { 60.0, 30.0 }) {
+				float y = RealPos.y + RealSize.y - (float)(scale / fps);
+				DrawList::Line({ RealPos.x, y }, { RealPos.x + RealSize.x, y }, 1, { 255,255,255,200 });
+			}
+		}
+	};
+
 	void initDebug(Instance* s) {
 		if (debugMenu) return;
 		debugMenu = new Object2D(s);
@@ -3985,7 +6873,7 @@ inline namespace debug {
 		******************/
 
 		Object2D* LogsFrame = new Object2D(debugMenu);
-		LogsFrame->Size = SpecialVector2{ 0.4, 0.6 };
+		LogsFrame->Size = SpecialVector2{ 0.4, 0.3 };
 		LogsFrame->Position = SpecialVector2{ 0.04, 0.3 };
 		LogsFrame->BackgroundTransparency = 0.2;
 		LogsFrame->BorderColor = DefaultDebugColor;
@@ -4030,6 +6918,85 @@ inline namespace debug {
 		}
 		textQueue.clear();
 
+		/******************
+		*    Profiler     *
+		******************/
+
+		Object2D* ProfilerFrame = new Object2D(debugMenu);
+		ProfilerFrame->Size = SpecialVector2{ 0.4, 0.28 };
+		ProfilerFrame->Position = SpecialVector2{ 0.04, 0.62 };
+		ProfilerFrame->BackgroundTransparency = 0.2;
+		ProfilerFrame->BorderColor = DefaultDebugColor;
+		ProfilerFrame->BorderThickness = 3;
+		ProfilerFrame->Name = "ProfilerFrame";
+
+		TextLabel* ProfilerName = new TextLabel(ProfilerFrame);
+		ProfilerName->Name = "ProfilerName";
+		ProfilerName->SetText("Profiler");
+		ProfilerName->TextSize = -1;
+		ProfilerName->TextColor = DefaultDebugColor;
+		ProfilerName->Position = SpecialVector2{ 0.5, 0 };
+		ProfilerName->AnchorPosition = SpecialVector2{ 0.5, 0 };
+		ProfilerName->Size = SpecialVector2{ 0.6, 0.12 };
+		ProfilerName->TextAnchor = TextAnchorEnum::CENTER;
+		ProfilerName->BackgroundTransparency = 1;
+		ProfilerName->SetFont(DEBUG_MENU_FONT_NAME);
+
+		TextLabel* TraceButton = new TextLabel(ProfilerFrame);
+		TraceButton->Name = "TraceButton";
+		TraceButton->SetText(" Trace ");
+		TraceButton->Position = SpecialVector2{ 0.82, 0.02 };
+		TraceButton->Size = SpecialVector2{ 0.16, 0.1 };
+		TraceButton->BackgroundColor = { 204, 255, 204, 255 };
+		TraceButton->Roundness = 0.5;
+		TraceButton->Active = true;
+		TraceButton->AddEvent(MOUSE_CLICK, [](Instance*) {
+			Profiler::CaptureTrace("simpleUI_trace.json", 120);
+			print("Recording 120 frames to simpleUI_trace.json");
+		}, LEFT);
+
+		ProfilerGraph* graph = new ProfilerGraph(ProfilerFrame);
+		graph->Name = "ProfilerGraph";
+		graph->Position = SpecialVector2{ 0.02, 0.15 };
+		graph->Size = SpecialVector2{ 0.6, 0.8 };
+		graph->BackgroundColor = { 0,0,0,255 };
+		graph->BackgroundTransparency = 0.1;
+
+		std::vector<TextLabel*> phaseLabels;
+		for (int p = -1; p < Profiler::PHASE_COUNT; p++) { // first row is the whole frame
+			TextLabel* label = new TextLabel(ProfilerFrame);
+			label->Name = p < 0 ? "frame" : Profiler::PhaseNames[p];
+			label->Position = SpecialVector2{ 0.65, 0.15f + (p + 1) * 0.08f };
+			label->Size = SpecialVector2{ 0.33, 0.08 };
+			label->TextColor = p < 0 ? Color{ 255,255,255,255 } : Profiler::PhaseColors[p];
+			label->TextAnchor = TextAnchorEnum::W;
+			label->BackgroundTransparency = 1;
+			phaseLabels.push_back(label);
+		}
+
+		ProfilerFrame->AddEvent(TICK, [phaseLabels](Instance*) { // averages of the last 60 frames, refreshed 4 times a second
+			static int frames = 0;
+			if (frames++ % 15) return;
+
+			double total = 0, phases[Profiler::PHASE_COUNT]{};
+			int hits = 0, misses = 0;
+			for (int age = 0; age < 60; age++) {
+				const Profiler::FrameRecord& f = Profiler::Frame(age);
+				total += f.Total;
+				for (int p = 0; p < Profiler::PHASE_COUNT; p++) phases[p] += f.Phases[p];
+				hits += f.MetricsHits;
+				misses += f.MetricsMisses;
+			}
+
+			for (int p = -1; p < Profiler::PHASE_COUNT; p++) {
+				std::ostringstream text;
+				text.precision(2);
+				text << std::fixed << (p < 0 ? "frame" : Profiler::PhaseNames[p]) << " " << (p < 0 ? total : phases[p]) / 60 * 1000 << " ms";
+				if (p == Profiler::PHASE_TEXT and hits + misses) text << " " << hits * 100 / (hits + misses) << "% cached";
+				phaseLabels[p + 1]->SetText(text.str());
+			}
+		});
+
 		/********************
 		* Objects hierarchy *
 		********************/
@@ -4070,16 +7037,41 @@ inline namespace debug {
 		ScrollFrame* treeScroll = new ScrollFrame(treeFrame);
 		treeScroll->Name = "treeScroll";
 		treeScroll->Position = SpecialVector2{ 0, 0.12 };
-		treeScroll->Size = SpecialVector2{ 0.5, 0.88 };
+		treeScroll->Size = SpecialVector2{ 1, 0.88 };
 		treeScroll->BackgroundTransparency = 1;
 		treeScroll->SliderColor = { 255,255,255,255 };
 		treeScroll->ScrollSpeed = 0.2;
 
+#if SUI_PROFILER
+		treeScroll->Position = SpecialVector2{ 0, 0.18 };
+		treeScroll->Size = SpecialVector2{ 1, 0.82 };
+
+		TextLabel* sortButton = new TextLabel(treeFrame);
+		sortButton->Name = "sortButton";
+		sortButton->SetText(" Sort: order ");
+		sortButton->TextColor = DefaultDebugColor;
+		sortButton->TextAnchor = TextAnchorEnum::W;
+		sortButton->BackgroundTransparency = 1;
+		sortButton->Position = SpecialVector2{ 0, 0.12 };
+		sortButton->Size = SpecialVector2{ 0.4, 0.05 };
+		sortButton->Active = true;
+		sortButton->AddEvent(MOUSE_CLICK, [sortButton](Instance*) {
+			costSort = (costSort + 1) % SORT_COUNT;
+			sortButton->SetText(std::string(" Sort: ") + CostSortNames[costSort] + " ");
+			refreshHierarchyCosts();
+		}, LEFT);
+
+		treeFrame->AddEvent(TICK, [](Instance*) { // twice a second, counters are of the frame being drawn
+			static int frames = 0;
+			if (frames++ % 30 == 0) refreshHierarchyCosts();
+		});
+#endif
+
 		/********************
 		*  Events Handler   *
 		********************/
 
-		new ChangedSignal<int>(currentColor, [treeScroll, way, manageMenu, treeName, LogsName, LogsFrame, lowerName, Colorright, ColorBlock, Colorleft, Colorlabel, FPSright, FPSquantity, FPSleft, FPSlabel, LGMlabel, AnimLabel, SettingsName, SettingsFrame]() {
+		new ChangedSignal<int>(currentColor, [ProfilerFrame, ProfilerName, treeScroll, way, manageMenu, treeName, LogsName, LogsFrame, lowerName, Colorright, ColorBlock, Colorleft, Colorlabel, FPSright, FPSquantity, FPSleft, FPSlabel, LGMlabel, AnimLabel, SettingsName, SettingsFrame]() {
 			Colorright->TextColor = typeColor[currentColor];
 			ColorBlock->BackgroundColor = typeColor[currentColor];
 			Colorleft->TextColor = typeColor[currentColor];
@@ -4097,33 +7089,21 @@ inline namespace debug {
 			console->BorderColor = typeColor[currentColor];
 			LogsFrame->BorderColor = typeColor[currentColor];
 			LogsName->TextColor = typeColor[currentColor];
+			ProfilerFrame->BorderColor = typeColor[currentColor];
+			ProfilerName->TextColor = typeColor[currentColor];
 			treeFrame->BorderColor = typeColor[currentColor];
 			treeName->TextColor = typeColor[currentColor];
 			manageMenu->BorderColor = typeColor[currentColor];
-			for (Instance* obj : console->Children) {
-				if (obj->Class == TEXTLABEL) {
-					TextLabel* t = static_cast<TextLabel*>(obj);
-					if (t) {
-						t->TextColor = typeColor[currentColor];
-					}
-				}
-			}
-			for (Instance* obj : way->Children) {
-				if (obj->Class == TEXTLABEL) {
-					TextLabel* t = static_cast<TextLabel*>(obj);
-					if (t) {
-						t->TextColor = typeColor[currentColor];
-					}
-				}
-			}
-			for (Instance* obj : treeScroll->Children) {
-				if (obj->Class == TEXTLABEL) {
-					TextLabel* t = static_cast<TextLabel*>(obj);
-					if (t) {
-						t->TextColor = typeColor[currentColor];
-					}
+			auto recolor = [&](Instance* parent) {
+				for (Instance* obj : parent->Children) {
+					if (!HasTrait(obj->Class, TRAIT_TEXT)) continue;
+					if (HasTrait(obj->Class, TRAIT_INPUT)) static_cast<TextBox*>(obj)->TextColor = typeColor[currentColor];
+					else static_cast<TextLabel*>(obj)->TextColor = typeColor[currentColor];
 				}
-			}
+			};
+			recolor(console);
+			recolor(way);
+			recolor(treeScroll);
 		});
 
 		new ChangedSignal<int>(currentFPSindex, [FPSquantity]() { SetTargetFPS((typeFPS[currentFPSindex] == 0) ? GetMonitorRefreshRate(GetCurrentMonitor()) : typeFPS[currentFPSindex]); std::ostringstream s; s << " " << typeFPS[currentFPSindex] << " "; FPSquantity->SetText(currentFPSindex == 2 ? "FULL" : ((currentFPSindex == 3) ? "V-SYNC" : s.str())); });
@@ -4173,6 +7153,9 @@ inline namespace debug {
 
 				static std::vector<Instance*> objects2;
 				objects2.clear();
+#if SUI_PROFILER
+				hierarchyRows.clear();
+#endif
 
 				bool dec = false;
 
@@ -4190,7 +7173,22 @@ inline namespace debug {
 					element->Active = true;
 					element->TextAnchor = TextAnchorEnum::W;
 					element->AddEvent(MOUSE_CLICK, [i, dec](Instance* t) { currentInstance = objects2[i - dec]; }, LEFT);
+
+#if SUI_PROFILER
+					element->Size = SpecialVector2{ 0.45, 0.05 };
+					TextLabel* stats = new TextLabel(treeScroll);
+					stats->Name = "stats";
+					stats->BackgroundTransparency = 1;
+					stats->TextColor = DefaultDebugColor;
+					stats->Position = SpecialVector2{ 0.45, (i - dec) * 0.05f };
+					stats->Size = SpecialVector2{ 0.55, 0.05 };
+					stats->TextAnchor = TextAnchorEnum::W;
+					hierarchyRows.push_back({ currentInstance->Children[i], element, stats, {} });
+#endif
 				}
+#if SUI_PROFILER
+				refreshHierarchyCosts();
+#endif
 
 				treeScroll->CanvasSize.y = (currentInstance->Children.size() - dec) * 0.05;
 				treeScroll->CanvasPosition.y = 0;
@@ -4205,6 +7203,9 @@ inline namespace debug {
 		}
 
 		debugMenu->Visible = !debugMenu->Visible;
+#if SUI_PROFILER
+		Profiler::ObjectCosts = debugMenu->Visible;
+#endif
 	}
 };
 
@@ -4230,134 +7231,527 @@ void SUI_SetMinimalWindowSize(int newX, int newY) {
 	windowMinimalSize = SpecialVector2{ (float)newX, (float)newY };
 }
 
-bool ALLOW_DEBUG = true;
-bool ALLOW_FPS = true;
-
-void UpdateHigher(Instance* StartInstance) {
-	Object2D* best = nullptr;
-	int maxDepth = -1;
-
-	std::function<bool(Instance*, int)> getTop = [&getTop, &best, &maxDepth](Instance* parent, int localDepth) -> bool {
-		bool foundInThisBranch = false;
-
-		if (parent->Class == SCROLLFRAME) {
-			ScrollFrame* scroll = static_cast<ScrollFrame*>(parent);
+// Layout is solved in a separate pass before the tree is updated, top level objects and ScrollFrame
+// contents are spread over threads. 1 solves on the main thread, more enables the layout store.
+void SUI_SetLayoutThreads(int count) {
+	if (count <= 0) count = std::max(1, (int)std::thread::hardware_concurrency());
+	LayoutStore::StartThreads(count);
+	if (LayoutStore::Threads > 1) LayoutStore::Enabled = true;
+}
 
-			for (auto sector : scroll->sectorsOnView) {
-				for (auto& [id, child] : sector->Objects) {
-					int nextDepth = localDepth;
-					bool isTarget = false;
+// Milliseconds per frame spent uploading decoded images, one upload step is done in every frame anyway.
+// Images wanted by the largest ImageLabels on screen are uploaded first.
+void SUI_SetImageUploadBudget(float milliseconds) {
+	ImageLoader::UploadBudget = std::max(0.0f, milliseconds) / 1000.0;
+}
 
-					if (scroll->childsRemovedInFrame.contains(id)) continue;
+// Pre-decoded images are kept in directory, warm starts map them instead of decoding the files. Empty turns it off.
+void SUI_SetImageCacheDir(const std::string& directory) {
+	ImageLoader::CacheDir = directory;
+}
 
-					if (!Is2DInheritor(child)) { // experemental branch. if not working then delete
-						if (getTop(child, nextDepth)) {
-							foundInThisBranch = true;
-						}
+// Writes the cache files of paths that have none or an outdated one, on the calling thread and without a window.
+// Every file is then read back from the cache, the report compares that with decoding.
+ImageLoader::CacheReport SUI_BuildImageCache(const std::vector<std::string>& paths) {
+	using clock = std::chrono::steady_clock;
+	ImageLoader::CacheReport report;
+	if (ImageLoader::CacheDir.empty()) {
+		std::cout << "Image cache: no directory, see SUI_SetImageCacheDir" << std::endl;
+		return report;
+	}
+
+	for (const std::string& path : paths) {
+		ImageLoader::CacheKey key;
+		ImageLoader::Decoded result;
+		result.Path = path;
+		if (!ImageLoader::cacheKey(path, key)) {
+			std::cout << "Image cache: " << path << " not found" << std::endl;
+			report.Failed++;
+			continue;
+		}
+
+		bool current = ImageLoader::readCache(result, key);
+		if (!current) {
+			auto start = clock::now();
+			Image img = LoadImage(path.c_str());
+			if (img.data) ImageLoader::makeTiers(result, img);
+			report.DecodeSeconds += std::chrono::duration<double>(clock::now() - start).count();
+			if (!img.data or !ImageLoader::writeCache(result, key)) {
+				std::cout << "Image cache: " << path << " could not be cached" << std::endl;
+				for (Image& tier : result.Tiers) UnloadImage(tier);
+				report.Failed++;
+				continue;
+			}
+		}
+		for (Image& tier : result.Tiers) UnloadImage(tier);
+		result.Tiers.clear();
+		result.Tier = 0;
 
-						if (foundInThisBranch) {
-							return true;
-						}
-					} else {
-						auto obj = static_cast<Object2D*>(child);
+		auto start = clock::now();
+		ImageLoader::readCache(result, key);
+		report.MappedSeconds += std::chrono::duration<double>(clock::now() - start).count();
+		for (Image& tier : result.Tiers) UnloadImage(tier);
+		if (current) report.Current++;
+		else report.Built++;
+	}
+	return report;
+}
 
-						if (obj) {
-							if (!obj->Visible) continue;
-							nextDepth = localDepth + 1;
-							if (obj->Active and obj->pointInObject(mousePosition)) {
-								isTarget = true;
-							}
-						}
+// Writes the next frames as a Chrome trace (chrome://tracing, Perfetto) once they are drawn
+void SUI_CaptureTrace(const std::string& path, int frames = 120) {
+#if SUI_PROFILER
+	Profiler::CaptureTrace(path, frames);
+#else
+	std::cout << "Profiler: compiled out, define SUI_PROFILER 1" << std::endl;
+#endif
+}
 
-						if (getTop(child, nextDepth)) {
-							foundInThisBranch = true;
-						}
+bool ALLOW_DEBUG = true;
+bool ALLOW_FPS = true;
 
-						if (isTarget) {
-							if (nextDepth > maxDepth or (nextDepth == maxDepth and (!best or obj->ZIndex > best->ZIndex))) {
-								best = obj;
-								maxDepth = nextDepth;
-								foundInThisBranch = true;
-							}
-						}
+// Same search UpdateHigher always did: children from the top one down, the first branch with a target stops it
+inline bool hitTestChildren(Instance* parent, int localDepth, Object2D*& best, int& maxDepth) {
+	bool foundInThisBranch = false;
 
-						if (foundInThisBranch) {
-							return true;
-						}
-					}
-				}
-			}
-		} else {
-			for (auto it = parent->Children.rbegin(); it != parent->Children.rend(); it++) {
-				Instance* child = *it;
+	if (HasTrait(parent->Class, TRAIT_SCROLL)) {
+		ScrollFrame* scroll = static_cast<ScrollFrame*>(parent);
 
+		for (auto sector : scroll->sectorsOnView) {
+			for (auto& [id, child] : sector->Objects) {
 				int nextDepth = localDepth;
 				bool isTarget = false;
 
+				if (scroll->childsRemovedInFrame.contains(id)) continue;
+
 				if (!Is2DInheritor(child)) { // experemental branch. if not working then delete
-					if (getTop(child, nextDepth)) {
+					if (hitTestChildren(child, nextDepth, best, maxDepth)) {
 						foundInThisBranch = true;
 					}
 
 					if (foundInThisBranch) {
 						return true;
 					}
-				}
+				} else {
+					auto obj = static_cast<Object2D*>(child);
+
+					if (obj) {
+						if (!obj->Visible) continue;
+						nextDepth = localDepth + 1;
+						if (obj->Active and obj->pointInObject(mousePosition)) {
+							isTarget = true;
+						}
+					}
 
-				auto obj = static_cast<Object2D*>(child);
+					if (hitTestChildren(child, nextDepth, best, maxDepth)) {
+						foundInThisBranch = true;
+					}
 
-				if (obj) {
-					if (!obj->Visible) continue;
-					nextDepth = localDepth + 1;
-					if (obj->Active and obj->pointInObject(mousePosition)) {
-						isTarget = true;
+					if (isTarget) {
+						if (nextDepth > maxDepth or (nextDepth == maxDepth and (!best or obj->ZIndex > best->ZIndex))) {
+							best = obj;
+							maxDepth = nextDepth;
+							foundInThisBranch = true;
+						}
 					}
-				}
 
-				if (getTop(child, nextDepth)) {
-					foundInThisBranch = true;
+					if (foundInThisBranch) {
+						return true;
+					}
 				}
+			}
+		}
+	} else {
+		for (auto it = parent->Children.rbegin(); it != parent->Children.rend(); it++) {
+			Instance* child = *it;
 
-				if (isTarget) {
-					if (nextDepth > maxDepth or (nextDepth == maxDepth and (!best or obj->ZIndex > best->ZIndex))) {
-						best = obj;
-						maxDepth = nextDepth;
-						foundInThisBranch = true;
-					}
+			int nextDepth = localDepth;
+			bool isTarget = false;
+
+			if (!Is2DInheritor(child)) { // experemental branch. if not working then delete
+				if (hitTestChildren(child, nextDepth, best, maxDepth)) {
+					foundInThisBranch = true;
 				}
 
 				if (foundInThisBranch) {
 					return true;
 				}
+				continue;
+			}
+
+			auto obj = static_cast<Object2D*>(child);
+
+			if (obj) {
+				if (!obj->Visible) continue;
+				nextDepth = localDepth + 1;
+				if (obj->Active and obj->pointInObject(mousePosition)) {
+					isTarget = true;
+				}
+			}
+
+			if (hitTestChildren(child, nextDepth, best, maxDepth)) {
+				foundInThisBranch = true;
+			}
+
+			if (isTarget) {
+				if (nextDepth > maxDepth or (nextDepth == maxDepth and (!best or obj->ZIndex > best->ZIndex))) {
+					best = obj;
+					maxDepth = nextDepth;
+					foundInThisBranch = true;
+				}
+			}
+
+			if (foundInThisBranch) {
+				return true;
 			}
 		}
+	}
 
+	return foundInThisBranch;
+}
 
+namespace HitIndex {
+	// The search above returns the last target in draw order (pre-order of the tree). Entries are numbered in that
+	// order with gaps: an entry keeps the numbers from Order to Limit for its descendants, so a parent whose children
+	// changed numbers only its own subtree again. Every cell keeps its entries sorted by number, so the first target
+	// found from the back of a cell wins. Everything is built again when a subtree runs out of numbers.
+	constexpr int CellSize = 128;
+	constexpr unsigned long long OrderRange = 1ull << 62;
+
+	struct Entry {
+		Object2D* Obj;
+		unsigned long long Order, Limit; // descendants are numbered between them
+		int X0, Y0, X1, Y1; // covered cells, X1 < X0 if none
+		bool Moved;
+	};
 
-		return foundInThisBranch;
+	struct Node {
+		Object2D* Obj;
+		size_t Size; // entries in its subtree with itself
 	};
 
-	getTop(StartInstance, 0);
+	inline std::vector<Entry> Entries;
+	inline std::vector<int> freeEntries;
+	inline std::map<unsigned long long, int> byOrder; // the entries of a subtree are one range
+	inline std::vector<std::vector<int>> Cells;
+	inline std::vector<int> scrollEntries; // ScrollFrames are checked at every point, their content is searched by sectors
+	inline std::vector<int> movedEntries;
+	inline std::vector<Instance*> changedParents; // children added, removed or reordered since the last refresh
+	inline std::vector<Node> nodes;
+	inline Instance* root = nullptr;
+	inline int columns = 0;
+	inline int rows = 0;
+
+	inline bool before(int a, int b) {
+		return Entries[a].Order < Entries[b].Order;
+	}
+
+	inline bool indexed(Object2D* obj) {
+		int i = obj->hitIndex;
+		return i >= 0 and i < (int)Entries.size() and Entries[i].Obj == obj;
+	}
+
+	inline void moved(Object2D* obj) {
+		if (structureDirty or !indexed(obj) or Entries[obj->hitIndex].Moved) return;
+		Entries[obj->hitIndex].Moved = true;
+		movedEntries.push_back(obj->hitIndex);
+	}
+
+	inline void changed(Instance* parent) {
+		if (!parent or structureDirty or parent->zOrderMark.HitChanged) return;
+		parent->zOrderMark.HitChanged = true;
+		changedParents.push_back(parent);
+	}
+
+	inline void discard(Instance* obj) {
+		if (!obj->zOrderMark.HitChanged) return;
+		obj->zOrderMark.HitChanged = false;
+		std::erase(changedParents, obj);
+	}
+
+	inline void cellRange(Entry& entry) {
+		Object2D* obj = entry.Obj;
+		float x0 = obj->RealPos.x, y0 = obj->RealPos.y;
+		float x1 = x0 + obj->RealSize.x, y1 = y0 + obj->RealSize.y;
+		float w = (float)(columns * CellSize), h = (float)(rows * CellSize);
+
+		if (!(x0 <= x1 and y0 <= y1 and x1 >= 0 and y1 >= 0 and x0 < w and y0 < h)) { // also false for NaN
+			entry.X0 = entry.Y0 = 0;
+			entry.X1 = entry.Y1 = -1;
+			return;
+		}
+
+		entry.X0 = (int)std::max(0.0f, x0 / CellSize);
+		entry.Y0 = (int)std::max(0.0f, y0 / CellSize);
+		entry.X1 = (int)std::min((float)(columns - 1), x1 / CellSize);
+		entry.Y1 = (int)std::min((float)(rows - 1), y1 / CellSize);
+	}
+
+	inline void insert(int i) {
+		const Entry& entry = Entries[i];
+		for (int y = entry.Y0; y <= entry.Y1; y++) {
+			for (int x = entry.X0; x <= entry.X1; x++) {
+				std::vector<int>& cell = Cells[y * columns + x];
+				cell.insert(std::upper_bound(cell.begin(), cell.end(), i, before), i);
+			}
+		}
+	}
+
+	inline void remove(int i) {
+		const Entry& entry = Entries[i];
+		for (int y = entry.Y0; y <= entry.Y1; y++) {
+			for (int x = entry.X0; x <= entry.X1; x++) {
+				std::vector<int>& cell = Cells[y * columns + x];
+				auto it = std::lower_bound(cell.begin(), cell.end(), i, before);
+				if (it != cell.end() and *it == i) cell.erase(it);
+			}
+		}
+	}
+
+	inline void drop(int i) { // takes the entry out of the grid and frees it
+		Entry& entry = Entries[i];
+		if (HasTrait(entry.Obj->Class, TRAIT_SCROLL)) {
+			auto it = std::lower_bound(scrollEntries.begin(), scrollEntries.end(), i, before);
+			if (it != scrollEntries.end() and *it == i) scrollEntries.erase(it);
+		} else {
+			remove(i);
+		}
+		byOrder.erase(entry.Order);
+		entry.Obj->hitIndex = -1;
+		entry.Obj = nullptr;
+		freeEntries.push_back(i);
+	}
+
+	inline void dropRange(unsigned long long from, unsigned long long to) { // entries numbered in [from, to)
+		std::vector<int> dropped;
+		for (auto it = byOrder.lower_bound(from); it != byOrder.end() and it->first < to; ++it) dropped.push_back(it->second);
+		for (int i : dropped) drop(i);
+	}
+
+	inline void forget(Object2D* obj) {
+		if (indexed(obj)) drop(obj->hitIndex);
+	}
+
+	inline size_t gather(Instance* parent) { // 2D descendants in pre-order, the old numbers of each are dropped
+		size_t count = 0;
+		for (Instance* child : parent->Children) {
+			if (!Is2DInheritor(child)) {
+				count += gather(child);
+				continue;
+			}
+
+			Object2D* obj = static_cast<Object2D*>(child);
+			if (indexed(obj)) dropRange(Entries[obj->hitIndex].Order, Entries[obj->hitIndex].Limit); // also descendants it lost
+			size_t at = nodes.size();
+			nodes.push_back({ obj, 1 });
+			if (!HasTrait(obj->Class, TRAIT_SCROLL)) nodes[at].Size += gather(obj);
+			count += nodes[at].Size;
+		}
+		return count;
+	}
+
+	inline bool renumber(Instance* parent, unsigned long long from, unsigned long long to) { // descendants get numbers in (from, to)
+		dropRange(from + 1, to);
+		nodes.clear();
+		gather(parent);
+		unsigned long long step = (to - from) / (nodes.size() + 1);
+		if (step == 0) return false;
+
+		for (size_t k = 0; k < nodes.size(); k++) {
+			int i;
+			if (freeEntries.empty()) {
+				i = (int)Entries.size();
+				Entries.emplace_back();
+			} else {
+				i = freeEntries.back();
+				freeEntries.pop_back();
+			}
+
+			Object2D* obj = nodes[k].Obj;
+			unsigned long long order = from + (k + 1) * step;
+			Entries[i] = Entry{ obj, order, order + nodes[k].Size * step, 0, 0, -1, -1, false };
+			obj->hitIndex = i;
+			byOrder.emplace_hint(byOrder.end(), order, i);
+
+			if (HasTrait(obj->Class, TRAIT_SCROLL)) {
+				scrollEntries.insert(std::upper_bound(scrollEntries.begin(), scrollEntries.end(), i, before), i);
+			} else {
+				cellRange(Entries[i]);
+				insert(i);
+			}
+		}
+		return true;
+	}
+
+	inline Instance* subtreeOf(Instance* parent) { // nearest numbered ancestor holding the children of parent, nullptr if they are not indexed
+		Instance* found = nullptr;
+		for (Instance* current = parent; current; current = current->Parent) {
+			if (current == root) return found ? found : root;
+			if (!Is2DInheritor(current)) continue;
+			Object2D* obj = static_cast<Object2D*>(current);
+			if (HasTrait(obj->Class, TRAIT_SCROLL)) return nullptr; // content found by sectors
+			if (!found and indexed(obj)) found = obj;
+		}
+		return nullptr; // not in the tree
+	}
+
+	inline bool renumberChanged() { // shallowest subtrees first, the ones inside them are numbered with them
+		std::vector<std::pair<int, Instance*>> changed;
+		for (Instance* parent : changedParents) {
+			parent->zOrderMark.HitChanged = false;
+			int depth = 0;
+			for (Instance* current = subtreeOf(parent); current; current = current->Parent) depth++;
+			changed.push_back({ depth, parent });
+		}
+		changedParents.clear();
+		std::stable_sort(changed.begin(), changed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		std::unordered_set<Instance*> done;
+		for (auto& [depth, parent] : changed) {
+			Instance* subtree = subtreeOf(parent);
+			if (!subtree) continue;
+
+			bool covered = false;
+			for (Instance* current = subtree; current and !covered; current = current->Parent) covered = done.contains(current);
+			if (covered) continue;
+			done.insert(subtree);
+
+			if (subtree == root) {
+				if (!renumber(root, 0, OrderRange)) return false;
+			} else {
+				const Entry& entry = Entries[static_cast<Object2D*>(subtree)->hitIndex];
+				if (!renumber(subtree, entry.Order, entry.Limit)) return false;
+			}
+		}
+		return true;
+	}
+
+	inline void build(Instance* start) {
+		for (Entry& entry : Entries) if (entry.Obj) entry.Obj->hitIndex = -1;
+		for (Instance* parent : changedParents) parent->zOrderMark.HitChanged = false;
+		Entries.clear();
+		freeEntries.clear();
+		byOrder.clear();
+		scrollEntries.clear();
+		movedEntries.clear();
+		changedParents.clear();
+
+		columns = std::max(0, winWidth) / CellSize + 1;
+		rows = std::max(0, winHeight) / CellSize + 1;
+		Cells.resize(columns * rows);
+		for (std::vector<int>& cell : Cells) cell.clear();
+
+		root = start;
+		structureDirty = false;
+		renumber(start, 0, OrderRange);
+	}
+
+	inline void refresh(Instance* start) {
+		if (structureDirty or root != start or columns != std::max(0, winWidth) / CellSize + 1 or rows != std::max(0, winHeight) / CellSize + 1
+			or !renumberChanged()) {
+			build(start);
+			return;
+		}
+
+		for (int i : movedEntries) {
+			Entry& entry = Entries[i];
+			entry.Moved = false;
+			if (!entry.Obj or HasTrait(entry.Obj->Class, TRAIT_SCROLL)) continue;
+			remove(i);
+			cellRange(entry);
+			insert(i);
+		}
+		movedEntries.clear();
+	}
+
+	inline bool visibleChain(Object2D* obj) { // invisible objects are skipped together with their descendants
+		for (Instance* current = obj; current and current != root; current = current->Parent) {
+			if (Is2DInheritor(current) and !static_cast<Object2D*>(current)->Visible) return false;
+		}
+		return true;
+	}
+
+	inline Object2D* Query(Instance* start, SpecialVector2 pos) {
+		refresh(start);
+
+		static const std::vector<int> empty;
+		const std::vector<int>* cell = &empty;
+		if (pos.x >= 0 and pos.y >= 0) {
+			int x = (int)(pos.x / CellSize);
+			int y = (int)(pos.y / CellSize);
+			if (x < columns and y < rows) cell = &Cells[y * columns + x];
+		}
+
+		auto a = cell->rbegin();
+		auto b = scrollEntries.rbegin();
+		while (a != cell->rend() or b != scrollEntries.rend()) {
+			int i = (b == scrollEntries.rend() or (a != cell->rend() and before(*b, *a))) ? *a++ : *b++;
+			Object2D* obj = Entries[i].Obj;
+			if (!obj or !visibleChain(obj)) continue;
+
+			if (HasTrait(obj->Class, TRAIT_SCROLL)) {
+				Object2D* best = nullptr;
+				int maxDepth = -1;
+				if (hitTestChildren(obj, 0, best, maxDepth)) return best;
+			}
+
+			if (obj->Active and obj->pointInObject(pos)) return obj;
+		}
+
+		return nullptr;
+	}
+}
+
+void UpdateHigher(Instance* StartInstance) {
+	SUI_PROFILE(Profiler::PHASE_HIT_TEST);
+	Object2D* best = nullptr;
+
+	if (HitIndex::Enabled) {
+		best = HitIndex::Query(StartInstance, mousePosition);
+	} else {
+		int maxDepth = -1;
+		hitTestChildren(StartInstance, 0, best, maxDepth);
+	}
+
 	PreviousHigherObject = higherObject;
 	higherObject = best;
 }
 
-void start(Instance& StartInstance, Vector3 inf, const char* name, const char* iconName = "", unsigned int flags = 4) {
-	SetConfigFlags(flags);
+inline void waitForEvents() {
+	if (!WAIT_FOR_EVENTS or headless()) return;
+	if (frameRequested.exchange(false)) return;
+	if (!Animate::ActiveAnimations.empty() or tickedInFrame or sceneDirty or !DrawList::damage.empty()) return;
+
+	float timeout = nextFrameIn;
+	Tasks::TasksMutex.lock();
+	for (Tasks::Task* t : Tasks::ActiveTasks) {
+		if (timeout < 0 or t->TimeLeft < timeout) timeout = t->TimeLeft;
+	}
+	Tasks::TasksMutex.unlock();
+
+	if (timeout < 0) glfwWaitEvents();
+	else if (timeout > 0) glfwWaitEventsTimeout(timeout);
+}
+
+inline void openWindow(Vector3 inf, const char* name, const char* iconName, unsigned int flags) {
 	SetTraceLogLevel(LOG_NONE);
 
 	winWidth = inf.x;
 	winHeight = inf.y;
-	
-	InitWindow(inf.x, inf.y, name);
-	if (windowMinimalSize.x != 0 and windowMinimalSize.y != 0) {
-		SetWindowMinSize(windowMinimalSize.x, windowMinimalSize.y);
-	}
-	int targetFPS = (inf.z <= 0) ? GetMonitorRefreshRate(GetCurrentMonitor()) : inf.z;
-	SetTargetFPS(targetFPS);
-	if (iconName != "") SetWindowIcon(LoadImage(iconName));
+	Input::Width = inf.x;
+	Input::Height = inf.y;
+
+	if (hasRenderer()) {
+		SetConfigFlags(HEADLESS == HEADLESS_OFFSCREEN ? flags | FLAG_WINDOW_HIDDEN : flags);
+		InitWindow(inf.x, inf.y, name);
+		if (windowMinimalSize.x != 0 and windowMinimalSize.y != 0) {
+			SetWindowMinSize(windowMinimalSize.x, windowMinimalSize.y);
+		}
+		int targetFPS = (inf.z <= 0) ? GetMonitorRefreshRate(GetCurrentMonitor()) : inf.z;
+		SetTargetFPS(headless() ? 0 : targetFPS); // headless frames are stepped as fast as they are drawn
+		if (iconName != "") SetWindowIcon(LoadImage(iconName));
 
-	SetExitKey(KEY_NULL);
+		SetExitKey(KEY_NULL);
+	}
 
 	createFont(BASIC_FONT_NAME, "Fonts/arial.ttf", 100); // Basic font 1
 	createFont(DEBUG_MENU_FONT_NAME, "Fonts/rogFont.otf", 50); // Basic font 2
@@ -4367,63 +7761,82 @@ void start(Instance& StartInstance, Vector3 inf, const char* name, const char* i
 		createFont(std::get<0>(tup), std::get<1>(tup), std::get<2>(tup));
 	}
 	queuedFonts.clear();
+}
 
-	for (auto& pair : pendingImages) {
-		Texture tex = LoadTextureFromImage(pair.second);
-		GenTextureMipmaps(&tex);
-		SetTextureFilter(tex, TEXTURE_FILTER_TRILINEAR);
-		SetTextureWrap(tex, TEXTURE_WRAP_CLAMP);
-		loadedImages.insert({ pair.first, {pair.second, tex} });
-	}
-
-	pendingImages.clear();
-
-	while (programRunning and !WindowShouldClose()) {
-		if (IsWindowFullscreen()) ToggleFullscreen();
-		if (changeWindowSizeB) {
-			SetWindowSize(changeWindowSize.x, changeWindowSize.y);
-			changeWindowSizeB = false;
-		}
-
-		static Vector2 previousMousePosition = {};
-		mousePosition = GetMousePosition();
-		mouseScreenPosition = GetMouseScreenPosition();
-		windowPosition = GetWindowPosition();
-		winWidth = GetScreenWidth(); winHeight = GetScreenHeight();
-
-		static long middleFPS = 0;
-		middleFPS += 1 / dt;
-		static double cd = 0;
-		cd += dt;
-		static int frames = 0;
-		frames++;
-
-		if (cd >= 0.1) {
-			cd = 0;
-			accurateFPS = middleFPS / frames;
-			middleFPS = 0;
-			frames = 0;
-		}
-
+inline void stepFrame(Instance& StartInstance) {
+	if (headless()) Input::Time += Input::FrameTime;
+#if SUI_PROFILER
+	Profiler::BeginFrame();
+#endif
+	if (IsWindowFullscreen()) ToggleFullscreen();
+	if (changeWindowSizeB) {
+		if (hasRenderer()) SetWindowSize(changeWindowSize.x, changeWindowSize.y);
+		Input::Width = changeWindowSize.x;
+		Input::Height = changeWindowSize.y;
+		changeWindowSizeB = false;
+	}
+
+	static Vector2 previousMousePosition = {};
+	mousePosition = GetMousePosition();
+	mouseScreenPosition = GetMouseScreenPosition();
+	windowPosition = GetWindowPosition();
+	winWidth = GetScreenWidth(); winHeight = GetScreenHeight();
+
+	static long middleFPS = 0;
+	middleFPS += 1 / dt;
+	static double cd = 0;
+	cd += dt;
+	static int frames = 0;
+	frames++;
+
+	if (cd >= 0.1) {
+		cd = 0;
+		accurateFPS = middleFPS / frames;
+		middleFPS = 0;
+		frames = 0;
+	}
+
+	{
+		SUI_PROFILE(Profiler::PHASE_SIGNALS);
 		updateSignals();
-		dt = GetFrameTime();
+	}
+	// GetFrameTime() would report time spent waiting for events one frame late
+	static double previousFrameStart = GetTime();
+	double frameStart = GetTime();
+	dt = WAIT_FOR_EVENTS ? (float)(frameStart - previousFrameStart) : GetFrameTime();
+	previousFrameStart = frameStart;
+	{
+		SUI_PROFILE(Profiler::PHASE_ANIMATIONS);
 		Animate::UpdateAnimations(dt);
+	}
+	{
+		SUI_PROFILE(Profiler::PHASE_TASKS);
 		Tasks::UpdateTasks(dt);
+	}
 
-		if (previousMousePosition.x != mousePosition.x or previousMousePosition.y != mousePosition.y or sceneDirty) {
-			previousMousePosition = mousePosition;
-			UpdateHigher(&StartInstance);
-		}
+	if (previousMousePosition.x != mousePosition.x or previousMousePosition.y != mousePosition.y or sceneDirty) {
+		previousMousePosition = mousePosition;
+		UpdateHigher(&StartInstance);
+	}
+	sceneDirty = false;
 
-		if (IsKeyPressed(KEY_F1) and ALLOW_FPS) { toggleFPS(&StartInstance, {125, 180, 220, 255}); }
-		if (IsKeyPressed(KEY_F2) and ALLOW_DEBUG) { debug::toggleDebug(&StartInstance); }
-		if (IsKeyPressed(KEY_F3)) { std::cout << accurateFPS << std::endl; }
+	if (IsKeyPressed(KEY_F1) and ALLOW_FPS) { toggleFPS(&StartInstance, {125, 180, 220, 255}); }
+	if (IsKeyPressed(KEY_F2) and ALLOW_DEBUG) { debug::toggleDebug(&StartInstance); }
+	if (IsKeyPressed(KEY_F3)) { std::cout << accurateFPS << std::endl; }
 
-		framesSinceStart += 1;
+	framesSinceStart += 1;
 
-		DrawFrame(&StartInstance);
-	}
+	tickedInFrame = false;
+	nextFrameIn = -1;
+	DrawFrame(&StartInstance);
+#if SUI_PROFILER
+	Profiler::EndFrame();
+#endif
+	waitForEvents();
+	if (headless()) Input::endFrame();
+}
 
+inline void closeWindow() {
 	/*
 	
 	for (int i = 0; i < StartInstance.Children.size();) {
@@ -4439,5 +7852,83 @@ void start(Instance& StartInstance, Vector3 inf, const char* name, const char* i
 
 	*/
 
-	CloseWindow();
+	ImageLoader::Stop();
+	TextAtlas::Shutdown();
+	DrawList::Shutdown();
+	LayoutStore::StopThreads();
+	if (hasRenderer()) CloseWindow();
+}
+
+void start(Instance& StartInstance, Vector3 inf, const char* name, const char* iconName = "", unsigned int flags = 4) {
+	openWindow(inf, name, iconName, flags);
+
+	while (programRunning and !WindowShouldClose()) {
+		stepFrame(StartInstance);
+	}
+
+	closeWindow();
+}
+// Headless driving, e.g. for CI: SUI_SetHeadless, SUI_Open, then SUI_Inject* and SUI_Step per frame, SUI_Close.
+// SUI_Step works with a window too, dt and injected input are only used headless.
+void SUI_SetHeadless(HeadlessMode mode) { // before SUI_Open
+	HEADLESS = mode;
+}
+
+void SUI_Open(Vector3 inf, const char* name = "simpleUI", unsigned int flags = 4) {
+	openWindow(inf, name, "", flags);
+}
+
+void SUI_Step(Instance& StartInstance, float dt = 1.0f / 60) {
+	Input::FrameTime = dt;
+	stepFrame(StartInstance);
+}
+
+void SUI_Close() {
+	closeWindow();
+}
+
+void SUI_InjectMouseMove(float x, float y) {
+	Input::Mouse = { x, y };
+}
+
+void SUI_InjectMouseButton(int button, bool down) {
+	if (button >= 0 and button < Input::BUTTONS) Input::Buttons[button] = down;
+}
+
+void SUI_InjectKey(int key, bool down) {
+	if (key >= 0 and key < Input::KEYS) Input::Keys[key] = down;
+}
+
+void SUI_InjectWheel(float move) {
+	Input::Wheel += move;
+}
+
+// Last drawn frame as an image file (format by extension). Without a renderer the recorded
+// draw commands are written as text instead, one per line.
+bool SUI_CaptureFrame(const std::string& path) {
+	if (!hasRenderer()) {
+		static const char* names[] = { "rectangle", "rectangle_lines", "texture", "texture_rounded", "line", "scissor", "end_scissor", "glyphs" };
+
+		std::ofstream out(path);
+		if (!out) return false;
+		for (const DrawList::Command& c : DrawList::Frame) {
+			out << names[c.Type] << ' ' << c.Rec.x << ' ' << c.Rec.y << ' ' << c.Rec.width << ' ' << c.Rec.height;
+			if (c.Type == DrawList::LINE) out << ' ' << c.From.x << ' ' << c.From.y << ' ' << c.To.x << ' ' << c.To.y;
+			if (c.Type == DrawList::GLYPHS) out << ' ' << c.Segments;
+			out << ' ' << (int)c.Tint.r << ' ' << (int)c.Tint.g << ' ' << (int)c.Tint.b << ' ' << (int)c.Tint.a << '\n';
+		}
+		return true;
+	}
+
+	Image image;
+	if (DrawList::target.id) { // frame is kept in the damage tracking target, render textures are upside down
+		image = LoadImageFromTexture(DrawList::target.texture);
+		ImageFlipVertical(&image);
+	} else {
+		image = LoadImageFromScreen();
+	}
+
+	bool saved = ExportImage(image, path.c_str());
+	UnloadImage(image);
+	return saved;
 }
\ No newline at end of file